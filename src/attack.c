@@ -14,6 +14,10 @@
 #include <stdio.h>
 #include <stdarg.h>
 
+#ifdef __AVX512F__
+#include <immintrin.h>
+#endif
+
 #include "chessdefs.h"
 #include "bitboard.h"
 #include "position.h"
@@ -155,6 +159,114 @@ bitboard_t sq_attackers(const pos_t *pos, const bitboard_t occ, const square_t s
     return attackers;
 }
 
+#ifdef __AVX512F__
+/* one lane per direction: N, S, E, W for orthogonal sliders, then
+ * NE, SW, NW, SE for diagonal ones. Shifts are rotations (negative shifts
+ * modulo 64), wrapped squares are removed by the masks.
+ */
+static const __m512i ks_rot = {
+    8, 64 - 8, 1, 64 - 1, 9, 64 - 9, 7, 64 - 7
+};
+static const __m512i ks_mask = {
+    ~RANK_1bb, ~RANK_8bb, ~FILE_Abb, ~FILE_Hbb,
+    ~(FILE_Abb | RANK_1bb), ~(FILE_Hbb | RANK_8bb),
+    ~(FILE_Hbb | RANK_1bb), ~(FILE_Abb | RANK_8bb)
+};
+#endif
+
+/**
+ * ks_sliders_attacks() - find all squares attacked by sliders
+ * @orth:   orthogonal sliders bitboard (rooks and/or queens)
+ * @diag:   diagonal sliders bitboard (bishops and/or queens)
+ * @empty:  empty squares bitboard
+ * @oatt:   &bitboard_t to store @orth attacks
+ * @datt:   &bitboard_t to store @diag attacks
+ *
+ * Kogge-Stone occluded fills for all sliders at once. With AVX-512, the
+ * eight directions are filled in parallel.
+ */
+static __always_inline void ks_sliders_attacks(const bitboard_t orth, const bitboard_t diag,
+                                               const bitboard_t empty,
+                                               bitboard_t *oatt, bitboard_t *datt)
+{
+#ifdef __AVX512F__
+    __m512i rot2 = _mm512_add_epi64(ks_rot, ks_rot);
+    __m512i rot4 = _mm512_add_epi64(rot2, rot2);
+    __m512i gen  = _mm512_mask_blend_epi64(0xf0, _mm512_set1_epi64(orth),
+                                           _mm512_set1_epi64(diag));
+    __m512i pro  = _mm512_and_si512(_mm512_set1_epi64(empty), ks_mask);
+
+    gen = _mm512_or_si512(gen, _mm512_and_si512(pro, _mm512_rolv_epi64(gen, ks_rot)));
+    pro = _mm512_and_si512(pro, _mm512_rolv_epi64(pro, ks_rot));
+    gen = _mm512_or_si512(gen, _mm512_and_si512(pro, _mm512_rolv_epi64(gen, rot2)));
+    pro = _mm512_and_si512(pro, _mm512_rolv_epi64(pro, rot2));
+    gen = _mm512_or_si512(gen, _mm512_and_si512(pro, _mm512_rolv_epi64(gen, rot4)));
+    gen = _mm512_and_si512(_mm512_rolv_epi64(gen, ks_rot), ks_mask);
+
+    *oatt = _mm512_mask_reduce_or_epi64(0x0f, gen);
+    *datt = _mm512_mask_reduce_or_epi64(0xf0, gen);
+#else
+    *oatt = bb_ks_rook_attacks(orth, empty);
+    *datt = bb_ks_bishop_attacks(diag, empty);
+#endif
+}
+
+/**
+ * pos_attacks() - find all squares attacked by a color
+ * @pos: position
+ * @occ: occupation mask used
+ * @c:   attacker color
+ *
+ * Find all squares attacked by @c pieces. En-passant is not considered.
+ * For example, to find the squares where @c opponent king cannot go, @occ
+ * should exclude this king (to catch king moving away from a slider on same
+ * line).
+ *
+ * @Return: a bitboard of attacked squares.
+ */
+bitboard_t pos_attacks(const pos_t *pos, const bitboard_t occ, const color_t c)
+{
+    const bitboard_t *bb = pos->bb[c];
+    bitboard_t oatt, datt;
+
+    ks_sliders_attacks(bb[ROOK] | bb[QUEEN], bb[BISHOP] | bb[QUEEN], ~occ, &oatt, &datt);
+    return oatt | datt |
+        bb_pawns_attacks(bb[PAWN], sq_up(c)) |
+        bb_knights_attacks(bb[KNIGHT]) |
+        bb_king[pos->king[c]];
+}
+
+/**
+ * pos_attack_maps() - find all squares attacked, by color and piece type
+ * @pos:     position
+ * @occ:     occupation mask used
+ * @attacks: bitboard_t[2][PT_NB] array to fill
+ *
+ * Same as pos_attacks(), for both colors, and separately for each piece
+ * type. @attacks[c][ALL_PIECES] is the union of @c attacks.
+ * This map can be shared by king moves legality, mobility, king safety
+ * and threats evaluation.
+ */
+void pos_attack_maps(const pos_t *pos, const bitboard_t occ,
+                     bitboard_t attacks[COLOR_NB][PT_NB])
+{
+    bitboard_t empty = ~occ, qo, qd;
+
+    for (color_t c = WHITE; c <= BLACK; ++c) {
+        const bitboard_t *bb = pos->bb[c];
+        bitboard_t *att = attacks[c];
+
+        att[PAWN]   = bb_pawns_attacks(bb[PAWN], sq_up(c));
+        att[KNIGHT] = bb_knights_attacks(bb[KNIGHT]);
+        att[KING]   = bb_king[pos->king[c]];
+        ks_sliders_attacks(bb[ROOK], bb[BISHOP], empty, att + ROOK, att + BISHOP);
+        ks_sliders_attacks(bb[QUEEN], bb[QUEEN], empty, &qo, &qd);
+        att[QUEEN]  = qo | qd;
+        att[ALL_PIECES] = att[PAWN] | att[KNIGHT] | att[BISHOP] |
+            att[ROOK] | att[QUEEN] | att[KING];
+    }
+}
+
 /**
  * sq_pinners() - get "pinners" on a square
  * @pos: position
@@ -177,7 +289,7 @@ bitboard_t sq_pinners(const pos_t *pos, const square_t sq, const color_t color)
     /* occupancy on sq diag and antidiag */
     lines = (bb_sqdiag[sq] | bb_sqanti[sq]) & occ;
     bit_for_each64(maybe_pinner, tmp, attackers) {
-        bitboard_t between = bb_between_excl[maybe_pinner][sq];
+        bitboard_t between = bb_between_excl(maybe_pinner, sq);
         /* keep only squares between AND on sq diag/anti */
         if (popcount64(between & lines) == 1)
             pinners |= BIT(maybe_pinner);
@@ -187,7 +299,7 @@ bitboard_t sq_pinners(const pos_t *pos, const square_t sq, const color_t color)
     attackers = pos->bb[color][ROOK] | pos->bb[color][QUEEN];
     lines = (bb_sqrank[sq] | bb_sqfile[sq]) & occ;
     bit_for_each64(maybe_pinner, tmp, attackers) {
-        bitboard_t between = bb_between_excl[maybe_pinner][sq];
+        bitboard_t between = bb_between_excl(maybe_pinner, sq);
         if (popcount64(between & lines) == 1)
             pinners |= BIT(maybe_pinner);
     }
@@ -211,6 +323,10 @@ bitboard_t sq_pinners(const pos_t *pos, const square_t sq, const color_t color)
  */
 bitboard_t sq_attackers_all(const pos_t *pos, const square_t sq)
 {
+#ifdef POS_ATTACKS
+    return pos->attackers[sq];
+#else
     bitboard_t occ = pos_occ(pos);
     return sq_attackers(pos, occ, sq, WHITE) | sq_attackers(pos, occ, sq, BLACK);
+#endif
 }
@@ -22,5 +22,8 @@ bool is_in_check(const pos_t *pos, const color_t color);
 
 bitboard_t sq_attackers(const pos_t *pos, const bitboard_t occ, const square_t sq, const color_t c);
 bitboard_t sq_attackers_all(const pos_t *pos, const square_t sq);
+bitboard_t pos_attacks(const pos_t *pos, const bitboard_t occ, const color_t c);
+void pos_attack_maps(const pos_t *pos, const bitboard_t occ,
+                     bitboard_t attacks[COLOR_NB][PT_NB]);
 bitboard_t sq_pinners(const pos_t *pos, const square_t sq, const color_t c);
 #endif
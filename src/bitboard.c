@@ -23,9 +23,9 @@
 
 bitboard_t bb_sq[64];
 bitboard_t bb_sqrank[64], bb_sqfile[64], bb_sqdiag[64], bb_sqanti[64];
-bitboard_t bb_between_excl[64][64];
-bitboard_t bb_between[64][64];
-bitboard_t bb_line[64][64];
+u8 sq_dir[64][64];
+bitboard_t bb_ray[DIR_NB][64];
+bitboard_t bb_dirline[DIR_NB][64];
 
 bitboard_t bb_knight[64], bb_king[64], bb_pawn_attacks[2][64];
 
@@ -86,8 +86,12 @@ bitboard_t bitboard_between_excl(square_t sq1, square_t sq2)
  *   bb_sqdiag[64]: square to diagonal
  *   bb_sqanti[64]: square to antidiagonal
  *
- *   bb_between_excl[64][64]: strict squares between two squares
- *   bb_between[64][64]: squares between two squares including second square
+ *   sq_dir[64][64]: direction between two squares
+ *   bb_ray[DIR_NB][64]: rays from square, per direction
+ *   bb_dirline[DIR_NB][64]: lines through square, per direction
+ *
+ * bb_between(), bb_between_excl() and bb_line() are computed from these
+ * tables (about 13Kb, instead of 3 x 32Kb for [64][64] bitboards tables).
  *
  * And the following pseudo move masks:
  *   bb_knight[64]: knight moves
@@ -103,19 +107,35 @@ void bitboard_init(void)
         { 1,  1 },                                /* diagonal */
         { 1, -1 },                                /* antidiagonal */
     } ;
+    /* rays vectors, in DIR_XXX order */
+    struct { int df, dr; } rays[8] = {
+        {  0,  1 }, {  1,  1 }, {  1,  0 }, {  1, -1 },
+        {  0, -1 }, { -1, -1 }, { -1,  0 }, { -1,  1 },
+    };
     bitboard_t tmpbb[64][4] = { 0 };
 
     /* 1) square to bitboard
-     *    in-between, sq2 excluded
+     *    rays and squares directions
      */
     for (square_t sq1 = A1; sq1 <= H8; ++sq1) {
         bb_sq[sq1] = BIT(sq1);
         for (square_t sq2 = A1; sq2 <= H8; ++sq2)
-            bb_between_excl[sq1][sq2] = bitboard_between_excl(sq1, sq2);
+            sq_dir[sq1][sq2] = DIR_NONE;
+        for (int dir = DIR_N; dir < DIR_NONE; ++dir) {
+            int df = rays[dir].df, dr = rays[dir].dr;
+            file_t f = sq_file(sq1) + df;
+            rank_t r = sq_rank(sq1) + dr;
+            for (; sq_coord_ok(f) && sq_coord_ok(r); f += df, r += dr) {
+                bb_ray[dir][sq1] |= BIT(sq_make(f, r));
+                sq_dir[sq1][sq_make(f, r)] = dir;
+            }
+        }
     }
+    for (square_t sq = A1; sq <= H8; ++sq)
+        for (int dir = DIR_N; dir < DIR_NONE; ++dir)
+            bb_dirline[dir][sq] = bb_ray[dir][sq] | bb_ray[dir ^ 4][sq] | BIT(sq);
 
-    /* 2) sq1-to-sq2 mask, sq2 included
-     *    square to file/rank/dia/anti bitmaps
+    /* 2) square to file/rank/dia/anti bitmaps
      */
     for (square_t sq = 0; sq < 64; ++sq) {
         file_t f = sq_file(sq);
@@ -125,12 +145,8 @@ void bitboard_init(void)
             for (int dir = -1; dir <= 1; dir += 2) {
                 file_t df = dir * vecs[vec].df, f2 = f + df;
                 rank_t dr = dir * vecs[vec].dr, r2 = r + dr;
-                bitboard_t mask_between = 0;
                 while (sq_coord_ok(f2) && sq_coord_ok(r2)) {
-                    square_t dest = sq_make(f2, r2);
-                    tmpbb[sq][vec] |= BIT(dest);
-                    mask_between |= BIT(dest);
-                    bb_between[sq][dest] = mask_between;
+                    tmpbb[sq][vec] |= BIT(sq_make(f2, r2));
                     f2 += df, r2 += dr;
                 }
             }
@@ -142,21 +158,6 @@ void bitboard_init(void)
         bb_sqdiag[sq] = tmpbb[sq][2];
         bb_sqanti[sq] = tmpbb[sq][3];
     }
-    for (square_t sq1 = 0; sq1 < 64; ++sq1) {
-        for (square_t sq2 = 0; sq2 < 64; ++sq2) {
-            if (sq1 != sq2) {
-                if (bb_sqfile[sq1] == bb_sqfile[sq2])
-                    bb_line[sq1][sq2] = bb_sqfile[sq1];
-                else if (bb_sqrank[sq1] == bb_sqrank[sq2])
-                    bb_line[sq1][sq2] = bb_sqrank[sq1];
-                else if (bb_sqdiag[sq1] == bb_sqdiag[sq2])
-                    bb_line[sq1][sq2] = bb_sqdiag[sq1];
-                else if (bb_sqanti[sq1] == bb_sqanti[sq2])
-                    bb_line[sq1][sq2] = bb_sqanti[sq1];
-            }
-        }
-    }
-
     /* 3) pawn, knight and king attacks
      */
     for (square_t sq = A1; sq <= H8; ++sq) {
@@ -23,10 +23,20 @@
 
 /* mapping square -> bitboard */
 extern bitboard_t bb_sq[64];
-/* squares between sq1 and sq2, exclusing both */
-extern bitboard_t bb_between_excl[64][64];
-/* squares between sq1 and sq2, including sq2 */
-extern bitboard_t bb_between[64][64];
+
+/* ray directions, clockwise from N. Opposite direction is (dir ^ 4) */
+enum {
+    DIR_N, DIR_NE, DIR_E, DIR_SE, DIR_S, DIR_SW, DIR_W, DIR_NW,
+    DIR_NONE,                                     /* squares not aligned */
+    DIR_NB
+};
+
+/* direction from sq1 to sq2, DIR_NONE if not aligned (or sq1 == sq2) */
+extern u8 sq_dir[64][64];
+/* squares from sq (excluded) to board edge, empty for DIR_NONE */
+extern bitboard_t bb_ray[DIR_NB][64];
+/* full line through sq, empty for DIR_NONE */
+extern bitboard_t bb_dirline[DIR_NB][64];
 
 /**
  * bb_sqrank[64]: square to rank
@@ -36,9 +46,6 @@ extern bitboard_t bb_between[64][64];
  */
 extern bitboard_t bb_sqrank[64], bb_sqfile[64], bb_sqdiag[64], bb_sqanti[64];
 
-/* line (rank, file, diagonal or anti-diagonal) between two squares */
-extern bitboard_t bb_line[64][64];
-
 /* pawn, knight and king attacks */
 extern bitboard_t bb_knight[64], bb_king[64], bb_pawn_attacks[2][64];
 
@@ -235,12 +242,120 @@ static __always_inline bitboard_t bb_pawns_attacks(const bitboard_t bb, int push
     return bb_shift(bb & ~FILE_Abb, push - 1) | bb_shift(bb & ~FILE_Hbb, push + 1);
 }
 
+/**
+ * bb_knights_attacks() - find all squares attacked by a set of knights
+ * @bb:      knights bitboard
+ *
+ * @return: squares attacked by @bb knights
+ */
+static __always_inline bitboard_t bb_knights_attacks(const bitboard_t bb)
+{
+    bitboard_t l1 = (bb >> 1) & ~FILE_Hbb, l2 = (bb >> 2) & ~(FILE_Gbb | FILE_Hbb);
+    bitboard_t r1 = (bb << 1) & ~FILE_Abb, r2 = (bb << 2) & ~(FILE_Abb | FILE_Bbb);
+    bitboard_t h1 = l1 | r1, h2 = l2 | r2;
+
+    return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
+}
+
+/**
+ * bb_ks_attacks() - Kogge-Stone sliding attacks in one direction
+ * @gen:   sliding pieces bitboard
+ * @empty: empty squares bitboard
+ * @dir:   direction (shift value)
+ * @mask:  squares reachable by a one-step @dir shift (avoids files wrapping)
+ *
+ * Occluded fill of all @gen pieces in @dir direction, in three parallel
+ * prefix steps. The fill is shifted one more step to include the blockers.
+ *
+ * @return: squares attacked by @gen pieces in @dir direction.
+ */
+static __always_inline bitboard_t bb_ks_attacks(bitboard_t gen, bitboard_t empty,
+                                                const int dir, const bitboard_t mask)
+{
+    empty &= mask;
+    gen   |= empty & bb_shift(gen, dir);
+    empty &= bb_shift(empty, dir);
+    gen   |= empty & bb_shift(gen, 2 * dir);
+    empty &= bb_shift(empty, 2 * dir);
+    gen   |= empty & bb_shift(gen, 4 * dir);
+    return bb_shift(gen, dir) & mask;
+}
+
+/**
+ * bb_ks_bishop_attacks() - find all squares attacked by diagonal sliders
+ * @bb:      bishops (and/or queens) bitboard
+ * @empty:   empty squares bitboard
+ *
+ * @return: squares attacked by @bb pieces on diagonals.
+ */
+static __always_inline bitboard_t bb_ks_bishop_attacks(const bitboard_t bb,
+                                                       const bitboard_t empty)
+{
+    return bb_ks_attacks(bb, empty, NORTH_EAST, ~FILE_Abb) |
+        bb_ks_attacks(bb, empty, SOUTH_EAST, ~FILE_Abb) |
+        bb_ks_attacks(bb, empty, NORTH_WEST, ~FILE_Hbb) |
+        bb_ks_attacks(bb, empty, SOUTH_WEST, ~FILE_Hbb);
+}
+
+/**
+ * bb_ks_rook_attacks() - find all squares attacked by orthogonal sliders
+ * @bb:      rooks (and/or queens) bitboard
+ * @empty:   empty squares bitboard
+ *
+ * @return: squares attacked by @bb pieces on ranks and files.
+ */
+static __always_inline bitboard_t bb_ks_rook_attacks(const bitboard_t bb,
+                                                     const bitboard_t empty)
+{
+    return bb_ks_attacks(bb, empty, NORTH, ~0ull) |
+        bb_ks_attacks(bb, empty, SOUTH, ~0ull) |
+        bb_ks_attacks(bb, empty, EAST, ~FILE_Abb) |
+        bb_ks_attacks(bb, empty, WEST, ~FILE_Hbb);
+}
+
 #define bb_rank(r)        ((u64) RANK_1bb << ((r) * 8))
 #define bb_file(f)        ((u64) FILE_Abb << (f))
 
 #define bb_rel_rank(r, c) bb_rank(sq_rel_rank(r, c))
 #define bb_rel_file(f, c) bb_file(sq_rel_rank(f, c)) /* likely useless */
 
+/**
+ * bb_between() - get squares between two squares, second one included.
+ * @sq1, @sq2:  the two squares.
+ *
+ * The ray from @sq1 towards @sq2 minus the ray from @sq2 in same direction.
+ *
+ * @return: squares between @sq1 and @sq2, including @sq2, 0 if not aligned.
+ */
+static __always_inline bitboard_t bb_between(square_t sq1, square_t sq2)
+{
+    int dir = sq_dir[sq1][sq2];
+
+    return bb_ray[dir][sq1] ^ bb_ray[dir][sq2];
+}
+
+/**
+ * bb_between_excl() - get squares strictly between two squares.
+ * @sq1, @sq2:  the two squares.
+ *
+ * @return: squares between @sq1 and @sq2 (both excluded), 0 if not aligned.
+ */
+static __always_inline bitboard_t bb_between_excl(square_t sq1, square_t sq2)
+{
+    return bb_between(sq1, sq2) & ~BIT(sq2);
+}
+
+/**
+ * bb_line() - get line (rank, file, diagonal or anti-diagonal) of two squares.
+ * @sq1, @sq2:  the two squares.
+ *
+ * @return: full line through @sq1 and @sq2, 0 if not aligned.
+ */
+static __always_inline bitboard_t bb_line(square_t sq1, square_t sq2)
+{
+    return bb_dirline[sq_dir[sq1][sq2]][sq1];
+}
+
 /**
  * bb_sq_aligned() - check if two squares are aligned (same file or rank).
  * @sq1, @sq2:  the two squares.
@@ -249,7 +364,7 @@ static __always_inline bitboard_t bb_pawns_attacks(const bitboard_t bb, int push
  */
 static __always_inline bool bb_sq_aligned(square_t sq1, square_t sq2)
 {
-    return bb_line[sq1][sq2];
+    return bb_line(sq1, sq2);
 }
 
 /**
@@ -260,7 +375,7 @@ static __always_inline bool bb_sq_aligned(square_t sq1, square_t sq2)
  */
 static __always_inline bool bb_sq_aligned3(square_t sq1, square_t sq2, square_t sq3)
 {
-    return bb_line[sq1][sq2] & BIT(sq3);
+    return bb_line(sq1, sq2) & BIT(sq3);
 }
 
 /**
@@ -273,7 +388,7 @@ static __always_inline bool bb_sq_aligned3(square_t sq1, square_t sq2, square_t
  */
 static __always_inline bitboard_t bb_sq_between(square_t sq, square_t sq1, square_t sq2)
 {
-    return bb_between_excl[sq1][sq2] & BIT(sq);
+    return bb_between_excl(sq1, sq2) & BIT(sq);
 }
 
 bitboard_t bitboard_between_excl(square_t sq1, square_t sq2);
@@ -91,6 +91,7 @@ typedef struct __movelist_s movelist_t;
 
 typedef u64 bitboard_t;
 typedef s16 eval_t;
+typedef s32 score_t;                              /* packed midgame/endgame eval_t */
 
 /* forward enum definition is impossible in C11.
  * To simplify cross-dependancies, all important enum are moved here.
@@ -22,6 +22,12 @@
 //#include "eval-simple.h"
 //#include "eval.h"
 
+/* phase weight per piece type, see calc_phase(). */
+const s8 pt_phase[PT_NB] = {
+    [PAWN] = P_PHASE, [KNIGHT] = N_PHASE, [BISHOP] = B_PHASE,
+    [ROOK] = R_PHASE, [QUEEN]  = Q_PHASE,
+};
+
 /* eval parameters definition. */
 static const struct ev_params ev_param_def [EV_PARAMS_NB] = {
     /*                type      setable def   min    max  name */
@@ -538,8 +544,7 @@ static const struct pst {
 };
 
 int pst_current = PST_DEFAULT;
-eval_t pst_mg[COLOR_NB][PT_NB][SQUARE_NB];
-eval_t pst_eg[COLOR_NB][PT_NB][SQUARE_NB];
+score_t pst_score[COLOR_NB][PT_NB][SQUARE_NB];
 
 void pst_set(char *str)
 {
@@ -571,17 +576,19 @@ void pst_init(int set)
     int wmat = param(WT_MAT);
     int wpst = param(WT_PST);
     for (piece_type_t pt = PAWN; pt < PT_NB; ++pt) {
-        eval_t mid_pc = piece_midval(pt);
-        eval_t end_pc = piece_endval(pt);
+        /* king: PST only. Its piece value (both sides have one) would
+         * overflow score_t halves with material weight > 100.
+         */
+        eval_t mid_pc = pt == KING? 0: piece_midval(pt);
+        eval_t end_pc = pt == KING? 0: piece_endval(pt);
         for (square_t sq = 0; sq < SQUARE_NB; ++sq) {
             eval_t mid_pst = pst->val[pt][MIDGAME][sq];
             eval_t end_pst = pst->val[pt][ENDGAME][sq];
 
-            pst_mg[BLACK][pt][sq] = (mid_pc * wmat + mid_pst * wpst) / 100;
-            pst_eg[BLACK][pt][sq] = (end_pc * wmat + end_pst * wpst) / 100;
-
-            pst_mg[WHITE][pt][FLIP_V(sq)] =  pst_mg[BLACK][pt][sq];
-            pst_eg[WHITE][pt][FLIP_V(sq)] =  pst_eg[BLACK][pt][sq];
+            pst_score[BLACK][pt][sq] =
+                make_score((mid_pc * wmat + mid_pst * wpst) / 100,
+                           (end_pc * wmat + end_pst * wpst) / 100);
+            pst_score[WHITE][pt][FLIP_V(sq)] = pst_score[BLACK][pt][sq];
         }
     }
 }
@@ -38,6 +38,7 @@ enum {
     Q_PHASE = 4,
     ALL_PHASE = P_PHASE*16 + N_PHASE*4 + B_PHASE*4 + R_PHASE*4 + Q_PHASE*2
 };
+extern const s8 pt_phase[PT_NB];                  /* phase weight per piece type */
 
 /* max pieces eval is 9*QUEEN_VALUE + 2*ROOK_VALUE + 2*BISHOP_VALUE
  * + 2*KNIGHT_VALUE which is (for a pawn valued at 100) well less than 15,000.
@@ -49,6 +50,28 @@ enum {
 
 #define EVAL_MATE    30000
 
+/**
+ * score_t - packed midgame and endgame values.
+ *
+ * Endgame value is stored in upper 16 bits, midgame value in lower 16 bits.
+ * Scores can be added or subtracted with one operation: The possible borrow
+ * from midgame value is taken into account when extracting endgame value.
+ */
+static __always_inline score_t make_score(const int mg, const int eg)
+{
+    return (score_t)((u32)eg << 16) + mg;
+}
+
+static __always_inline eval_t score_mg(const score_t score)
+{
+    return (s16)(u16)(u32)score;
+}
+
+static __always_inline eval_t score_eg(const score_t score)
+{
+    return (s16)(u16)((u32)(score + 0x8000) >> 16);
+}
+
 /* eval parameters */
 enum {
     WT_MAT,
@@ -109,8 +132,7 @@ enum {
 
 #define PST_DEFAULT PST_CPW
 extern int pst_current;
-extern eval_t pst_mg[COLOR_NB][PT_NB][SQUARE_NB];
-extern eval_t pst_eg[COLOR_NB][PT_NB][SQUARE_NB];
+extern score_t pst_score[COLOR_NB][PT_NB][SQUARE_NB];
 
 void pst_set(char *str);
 int pst_find(char *str);
@@ -45,45 +45,54 @@ eval_t eval_material(pos_t *pos)
 }
 
 /**
- * eval_simple() - simple and fast position evaluation
- * @pos: &position to evaluate
+ * eval_simple_calc() - calculate position material and PST values
+ * @pos: &position
  *
- * This function is normally used only during initialization,
- * or when changing phase (middlegame <--> endgame), as the eval
- * will be done incrementally when doing moves.
+ * Calculate @pos midgame and endgame material + piece-square values, as
+ * white value minus black one.
+ * These values are normally incrementally updated when doing moves (see
+ * pos->psq). This function should only be called when starting a new
+ * position, or to verify incremental calculation.
  *
- * @return: the @pos evaluation in centipawns
+ * @return: @pos packed midgame and endgame values.
  */
-eval_t eval_simple(pos_t *pos)
+score_t eval_simple_calc(const pos_t *pos)
 {
-    eval_t eval[2] = { 0, 0 };
-    eval_t mg_eval[2], eg_eval[2];
-    //struct pc_sq = sq_ int (*gg)[6 + 2][64] = eg? pc_sq_eg: pc_sq_mg;
-
-    //pos->eval_simple_phase = ENDGAME;
+    score_t score[COLOR_NB] = { 0 };
 
     for (color_t color = WHITE; color < COLOR_NB; ++color) {
-        mg_eval[color] = 0;
-        eg_eval[color] = 0;
-        for (piece_type_t pt = PAWN; pt < KING; pt++) {
+        for (piece_type_t pt = PAWN; pt <= KING; pt++) {
             bitboard_t bb = pos->bb[color][pt];
-            while (bb) {
-                square_t sq = bb_next(&bb);
-                mg_eval[color] += pst_mg[color][pt][sq];
-                eg_eval[color] += pst_eg[color][pt][sq];
-            }
+            while (bb)
+                score[color] += pst_score[color][pt][bb_next(&bb)];
 
 #           ifdef DEBUG_EVAL
             printf("c=%d pt=%d mg=%d eg=%d\n", color, pt,
-                   mg_eval[color], eg_eval[color]);
+                   score_mg(score[color]), score_eg(score[color]));
 #           endif
 
         }
     }
+    return score[WHITE] - score[BLACK];
+}
+
+/**
+ * eval_simple() - simple and fast position evaluation
+ * @pos: &position to evaluate
+ *
+ * Interpolate position incremental midgame and endgame values (see
+ * eval_simple_calc()) by position incremental game phase.
+ *
+ * @return: the @pos evaluation in centipawns
+ */
+eval_t eval_simple(pos_t *pos)
+{
+    int phase = max(pos->phase, 0);
+    int mg = score_mg(pos->psq), eg = score_eg(pos->psq);
+
 #   ifdef DEBUG_EVAL
-    printf("phase:%d mg[WHITE]:%d mg[BLACK]:%d eg[WHITE]:%d eg[BLACK]:%d\n",
-           pos->phase, mg_eval[WHITE], mg_eval[BLACK], eg_eval[WHITE], eg_eval[BLACK]);
+    printf("phase:%d mg:%d eg:%d\n", phase, mg, eg);
 #   endif
 
-    return eval[WHITE] - eval[BLACK];
+    return (mg * (ALL_PHASE - phase) + eg * phase) / ALL_PHASE;
 }
@@ -48,6 +48,7 @@
 //void eval_simple_init(char *set);
 
 eval_t eval_material(pos_t *pos);
+score_t eval_simple_calc(const pos_t *pos);
 eval_t eval_simple(pos_t *pos);
 
 #endif  /* EVAL_SIMPLE_H */
@@ -25,10 +25,12 @@
  * @pos: &position
  *
  * This function should be calculated when a new position is setup, or as
- * a verification of an incremental one.
- * phase is clamped between 0 (opening) and 24 (ending).
+ * a verification of an incremental one (see pos->phase, updated by
+ * move_do()).
+ * phase is 0 (opening) to 24 (ending). It is not clamped, as it can be
+ * negative after promotions: It must be clamped to 0 when used.
  *
- * @return:
+ * @return: @pos phase.
  */
 s16 calc_phase(pos_t *pos)
 {
@@ -39,7 +41,6 @@ s16 calc_phase(pos_t *pos)
     phase -= R_PHASE * popcount64(pos->bb[WHITE][ROOK]   | pos->bb[BLACK][ROOK]);
     phase -= Q_PHASE * popcount64(pos->bb[WHITE][QUEEN]  | pos->bb[BLACK][QUEEN]);
 
-    phase = max(phase, 0);
 #   ifdef DEBUG_EVAL
     printf("calculated phase:%d\n", phase);
 #   endif
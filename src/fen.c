@@ -24,6 +24,7 @@
 #include "alloc.h"
 #include "position.h"
 #include "eval-defs.h"
+#include "eval-simple.h"
 #include "fen.h"
 
 /* FEN description:
@@ -259,7 +260,10 @@ end:
         return NULL;                              /* invalid position: ignored */
 
     tmppos.key = zobrist_calc(&tmppos);
+    tmppos.material = zobrist_material_calc(&tmppos);
     tmppos.phase = calc_phase(&tmppos);
+    tmppos.psq = eval_simple_calc(&tmppos);
+    pos_set_checkers_pinners_blockers(&tmppos);
     if (!pos)
         pos = pos_new();
     pos_copy(&tmppos, pos);
@@ -16,6 +16,7 @@
 
 #include <brlib.h>
 #include <bitops.h>
+#include <likely.h>
 #include <bug.h>
 
 #include "chessdefs.h"
@@ -29,6 +30,7 @@ u64 zobrist_pieces[16][64];
 u64 zobrist_castling[4 * 4 + 1];
 u64 zobrist_turn;                                 /* for black, XOR each ply */
 u64 zobrist_ep[9];                                /* 0-7: ep file, 8: SQUARE_NONE */
+u32 zobrist_material[16];                         /* material key, added per piece */
 
 hasht_t hash_tt;                                  /* main transposition table */
 
@@ -54,6 +56,9 @@ void zobrist_init(void)
             zobrist_ep[f] = rand64();
         zobrist_ep[8] = 0;                        /* see EP_ZOBRIST_IDX macro */
         zobrist_turn = rand64();
+        for (color_t c = WHITE; c <= BLACK; ++c)
+            for (piece_type_t p = PAWN; p <= KING; ++p)
+                zobrist_material[MAKE_PIECE(p, c)] = rand64();
     }
 }
 
@@ -92,6 +97,28 @@ hkey_t zobrist_calc(pos_t *pos)
     return key;
 }
 
+/**
+ * zobrist_material_calc() - calculate a position material key.
+ * @pos: &position
+ *
+ * Material key is the sum (not XOR) of each piece zobrist_material value,
+ * so that a capture or promotion only needs an addition or subtraction,
+ * without knowing pieces count. Kings are not included.
+ * Like Zobrist key, material key is normally incrementally calculated when
+ * doing or undoing a move.
+ *
+ * @return: @pos material key
+ */
+u32 zobrist_material_calc(pos_t *pos)
+{
+    u32 key = 0;
+
+    for (color_t c = WHITE; c <= BLACK; ++c)
+        for (piece_type_t pt = PAWN; pt < KING; ++pt)
+            key += popcount64(pos->bb[c][pt]) * zobrist_material[MAKE_PIECE(pt, c)];
+    return key;
+}
+
 /**
  * zobrist_verify() - verify current position Zobrist key.
  * @pos: &position
@@ -161,6 +188,10 @@ end:
  * This means the actual size could be lower than @sizemb (nearly halved in
  * worst case).
  *
+ * Only the table geometry is set here: Memory is allocated (and cleared) on
+ * first store, see tt_bucket(). Until then, all probes miss. This keeps
+ * startup time near zero for processes which never use the table.
+ *
  * If transposition hashtable already exists and new size would not change,
  * the old one is cleared.
  * If transposition hashtable already exists and new size is different,
@@ -169,8 +200,7 @@ end:
  * TODO:
  * - Rebuild old hashtable data ?
  *
- * @return: hash table size in Mb. If memory allocation fails, the function does
- * not return.
+ * @return: hash table size in Mb.
  */
 int tt_create(s32 sizemb)
 {
@@ -204,8 +234,6 @@ int tt_create(s32 sizemb)
 
         hash_tt.mask     = BIT_ALL >> (64 - nbits);
 
-        hash_tt.keys     = safe_alloc_aligned_hugepage(hash_tt.bytes);
-
         //printf("bits=%2d size=%'15lu/%'6d Mb/%'14lu buckets ",
         //       hash_tt.nbits, hash_tt.bytes, hash_tt.mb, hash_tt.nbuckets);
         //printf("mask=%9x\n", hash_tt.mask);
@@ -213,12 +241,46 @@ int tt_create(s32 sizemb)
     //else {
     //    printf("unchanged (cleared)\n");
     //}
-    /* attention - may fail ! */
     tt_clear();
 
     return hash_tt.nbits;
 }
 
+/**
+ * tt_alloc() - allocate transposition table memory.
+ *
+ * Allocate and clear table memory, with geometry set by tt_create().
+ * If memory allocation fails, the function does not return.
+ */
+static void tt_alloc(void)
+{
+    bug_on(!hash_tt.bytes);
+    hash_tt.keys = safe_alloc_aligned_hugepage(hash_tt.bytes);
+    tt_clear();
+}
+
+/**
+ * tt_bucket() - get bucket for a key.
+ * @key: Zobrist (hkey_t) key
+ * @alloc: true if table must be allocated
+ *
+ * Table memory is allocated on first call with @alloc set. If @alloc is
+ * false and table is not allocated yet, a dummy empty bucket is returned.
+ *
+ * @return: @key bucket address.
+ */
+static __always_inline bucket_t *tt_bucket(const hkey_t key, const bool alloc)
+{
+    static bucket_t empty;
+
+    if (unlikely(!hash_tt.keys)) {
+        if (!alloc)
+            return &empty;
+        tt_alloc();
+    }
+    return hash_tt.keys + (key & hash_tt.mask);
+}
+
 /**
  * tt_clear() - clear transposition table
  *
@@ -260,8 +322,7 @@ hentry_t *tt_probe(hkey_t key)
     hentry_t *entry;
     int i;
 
-    bug_on(!hash_tt.keys);
-    bucket = hash_tt.keys + (key & hash_tt.mask);
+    bucket = tt_bucket(key, false);
 
     /* find key in buckets */
     for (i = 0; i < ENTRIES_PER_BUCKET; ++i) {
@@ -289,8 +350,7 @@ hentry_t *tt_probe_perft(const hkey_t key, const u16 depth)
     hentry_t *entry;
     int i;
 
-    bug_on(!hash_tt.keys);
-    bucket = hash_tt.keys + (key & hash_tt.mask);
+    bucket = tt_bucket(key, false);
 
     /* find key in buckets */
     for (i = 0; i < ENTRIES_PER_BUCKET; ++i) {
@@ -334,8 +394,7 @@ hentry_t *tt_store_perft(const hkey_t key, const u16 depth, const u64 nodes)
      * printf("tt_store: key=%lx depth=%d nodes=%lu ",
      *        key, depth, nodes);
      */
-    bug_on(!hash_tt.keys);
-    bucket = hash_tt.keys + (key & hash_tt.mask);
+    bucket = tt_bucket(key, true);
 
     /* find key in buckets */
     for (int i = 0; i < ENTRIES_PER_BUCKET; ++i) {
@@ -395,7 +454,7 @@ void tt_info()
                hash_tt.mb, hash_tt.nbuckets, hash_tt.nbits,
                hash_tt.mask, hash_tt.nkeys);
     } else {
-        printf("TT: not set.\n");
+        printf("TT: Mb:%d (not allocated yet)\n", hash_tt.mb);
     }
 }
 
@@ -108,11 +108,13 @@ extern hkey_t zobrist_pieces[16][64];
 extern hkey_t zobrist_castling[4 * 4 + 1];
 extern hkey_t zobrist_turn;                       /* for black, XOR each ply */
 extern hkey_t zobrist_ep[9];                      /* 0-7: ep file, 8: SQUARE_NONE */
+extern u32 zobrist_material[16];                  /* material key, added per piece */
 
 extern hasht_t hash_tt;                           /* main transposition table */
 
 void zobrist_init(void);
 hkey_t zobrist_calc(pos_t *pos);
+u32 zobrist_material_calc(pos_t *pos);
 
 #ifdef ZOBRIST_VERIFY
 bool zobrist_verify(pos_t *pos);
@@ -124,12 +126,12 @@ bool zobrist_verify(pos_t *pos);
  * tt_prefetch() - prefetch hash table entry
  * @hash: u64 key
  *
- * Prefetch memory for @key.
+ * Prefetch memory for @key. Nothing is done if table is not allocated yet.
  */
 static inline void tt_prefetch(hkey_t key)
 {
-    bug_on(!hash_tt.keys);
-    __builtin_prefetch(hash_tt.keys + (key & hash_tt.mask));
+    if (hash_tt.keys)
+        __builtin_prefetch(hash_tt.keys + (key & hash_tt.mask));
 }
 
 int tt_create(int Mb);
@@ -76,49 +76,6 @@ void hq_init()
     }
 }
 
-/**
- * hq_rank_moves() - get rank moves for a sliding piece.
- * @pieces: occupation bitboard
- * @sq: piece square
- *
- * Rank attacks are not handled by HQ, so this function uses a pre-calculated
- * rank attacks table (@bb_rank_attacks).
- *
- * @Return: bitboard of @piece available pseudo-moves.
- */
-bitboard_t hq_rank_moves(bitboard_t occ, square_t sq)
-{
-    u32 rank = sq & SQ_RANKMASK;
-    u32 file = sq & SQ_FILEMASK;
-    u64 o = (occ >> rank) & 0176;                 /* 01111110 clear bits 0 & 7 */
-    return ((bitboard_t)bb_rank_attacks[(o << 2) + file]) << rank;
-}
-
-/**
- * hq_moves() - get hyperbola pseudo-moves for a sliding piece
- * @pieces: occupation bitboard
- * @sq: piece square
- * @mask: the appropriate mask (pre-calculated)
- *
- * This function can be used for files, diagonal, and anti-diagonal attacks.
- * @mask is the corresponding pre-calculated table (@bb_sqfile, @bb_sqdiag,
- * or @bb_sqanti).
- * See https://www.chessprogramming.org/Hyperbola_Quintessence for details.
- *
- * @Return: bitboard of piece available pseudo-moves.
- */
-bitboard_t hq_moves(const bitboard_t pieces, const square_t sq,
-                                   const bitboard_t mask)
-{
-    bitboard_t o = pieces & mask;
-    bitboard_t r = bswap64(o);
-    square_t  r_sq = FLIP_V(sq);
-
-    return (         (o - 2 * BIT(sq)   )
-            ^ bswap64(r - 2 * BIT(r_sq)))
-        & mask;
-}
-
 /**
  * hq_file_moves() - get file pseudo-moves for a sliding piece.
  * @pieces: occupation bitboard
@@ -17,11 +17,53 @@
 #include "board.h"
 #include "bitboard.h"
 
+extern uchar bb_rank_attacks[64 * 8];
+
 void hq_init(void);
 
-bitboard_t hq_rank_moves(const bitboard_t occ, const square_t sq);
-bitboard_t hq_moves(const bitboard_t pieces, const square_t sq,
-                           const bitboard_t mask);
+/**
+ * hq_rank_moves() - get rank moves for a sliding piece.
+ * @pieces: occupation bitboard
+ * @sq: piece square
+ *
+ * Rank attacks are not handled by HQ, so this function uses a pre-calculated
+ * rank attacks table (@bb_rank_attacks).
+ *
+ * @Return: bitboard of @piece available pseudo-moves.
+ */
+static __always_inline bitboard_t hq_rank_moves(const bitboard_t occ, const square_t sq)
+{
+    u32 rank = sq & SQ_RANKMASK;
+    u32 file = sq & SQ_FILEMASK;
+    u64 o = (occ >> rank) & 0176;                 /* 01111110 clear bits 0 & 7 */
+    return ((bitboard_t)bb_rank_attacks[(o << 2) + file]) << rank;
+}
+
+/**
+ * hq_moves() - get hyperbola pseudo-moves for a sliding piece
+ * @pieces: occupation bitboard
+ * @sq: piece square
+ * @mask: the appropriate mask (pre-calculated)
+ *
+ * This function can be used for files, diagonal, and anti-diagonal attacks.
+ * @mask is the corresponding pre-calculated table (@bb_sqfile, @bb_sqdiag,
+ * or @bb_sqanti).
+ * See https://www.chessprogramming.org/Hyperbola_Quintessence for details.
+ *
+ * @Return: bitboard of piece available pseudo-moves.
+ */
+static __always_inline bitboard_t hq_moves(const bitboard_t pieces, const square_t sq,
+                                           const bitboard_t mask)
+{
+    bitboard_t o = pieces & mask;
+    bitboard_t r = bswap64(o);
+    square_t  r_sq = FLIP_V(sq);
+
+    return (         (o - 2 * BIT(sq)   )
+            ^ bswap64(r - 2 * BIT(r_sq)))
+        & mask;
+}
+
 bitboard_t hq_file_moves(const bitboard_t occ, const square_t sq);
 bitboard_t hq_diag_moves(const bitboard_t occ, const square_t sq);
 bitboard_t hq_anti_moves(const bitboard_t occ, const square_t sq);
@@ -14,6 +14,7 @@
 #include <malloc.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <brlib.h>
 #include <likely.h>
@@ -24,6 +25,7 @@
 #include "position.h"
 #include "move-do.h"
 #include "hash.h"
+#include "eval-defs.h"
 
 /**
  * sq_castle - castling rights per square.
@@ -40,39 +42,29 @@ castle_rights_t sq_castle[64] = {
 };
 
 /**
- * move_do() - do move.
- * @pos:    &pos_t position
- * @move:   move to apply
- * @state:  &state_t address where irreversible changes will be saved
+ * _move_do() - do move, for a constant color.
+ * @piece:    piece on @move "from" square
+ * @captured: piece on @move "to" square
+ * @us:       color which played the move
  *
- * @move is applied to @pos:
- * - bitboards and board are updated
- * - counters are updated:
- *   - move count
- *   - 50-moves rule count
- * - flags are possibly updated:
- *   - castling
- *   - en-passant
- * - captured piece (excl. en-passant)
- * - tt hash values are updated for:
- *   - side-to-move
- *   - en-passant
- *   - castling rights.
- *
- * @return: updated pos.
+ * See move_do(). @state may be NULL (see move_do_copy()).
  */
-pos_t *move_do(pos_t *pos, const move_t move, state_t *state)
+static __always_inline pos_t *_move_do(pos_t *pos, const move_t move,
+                                       const piece_t piece, const piece_t captured,
+                                       state_t *state, const color_t us)
 {
-    color_t us = pos->turn, them = OPPONENT(us);
+    color_t them = OPPONENT(us);
     square_t from = move_from(move), to = move_to(move);
-    piece_t piece = pos->board[from];
-    piece_t captured = pos->board[to];
-    piece_type_t ptype = PIECE(piece);
-    piece_t new_piece = piece;
+    castle_rights_t castle = pos->castle;
     int up = sq_up(us);
     hkey_t key = pos->key;
+    score_t score = 0;                            /* material+PST change, @us side */
+    piece_type_t pt = PIECE(piece);
 
-    *state = pos->state;                          /* save irreversible changes */
+    bug_on(COLOR(piece) != us);
+
+    if (state)                                    /* NULL for copy-make */
+        *state = pos->state;                      /* save irreversible changes */
 
     /* update key: switch turn, reset ep */
     key ^= zobrist_turn;
@@ -85,76 +77,251 @@ pos_t *move_do(pos_t *pos, const move_t move, state_t *state)
     pos->captured = captured;
     pos->move = move;
 
-    bug_on(COLOR(piece) != us);
-
-    /* special moves: captures, pawn double push, en-passant, castling.
-     * All these moves are exclusive (so we use if ... else)
+    /* each move kind (from move flags) has its own path.
+     * Castling rights can only change when leaving or capturing on a
+     * rook or king initial square, or when castling.
      */
-    if (captured != EMPTY) {                      /* capture: remove piece */
-        pos->clock_50 = 0;
-        bug_on(pos->board[to] == EMPTY || COLOR(pos->captured) != them);
-        key ^= zobrist_pieces[captured][to];
-        pos_clr_sq(pos, to);
-    } else if (ptype == PAWN) {
-        pos->clock_50 = 0;
-        if (from + up + up == to) {               /* double push: set e.p. */
-            square_t ep = from + up;
-            /* check that opponent can e.p. */
-            if (bb_pawn_attacks[us][ep] & pos->bb[them][PAWN]) {
-                pos->en_passant = ep;
-                key ^= zobrist_ep[EP_ZOBRIST_IDX(pos->en_passant)];
+    switch (move_flags(move)) {
+        case M_NORMAL:
+            if (captured != EMPTY) {              /* capture: remove piece */
+                bug_on(COLOR(captured) != them);
+                pos->clock_50 = 0;
+                key ^= zobrist_pieces[captured][to];
+                score += pst_score[them][PIECE(captured)][to];
+                pos->material -= zobrist_material[captured];
+                pos->phase += pt_phase[PIECE(captured)];
+                pos_clr_sq(pos, to);
+                castle &= sq_castle[to];
+            } else if (pt == PAWN) {
+                pos->clock_50 = 0;
+                if (from + up + up == to) {       /* double push: set e.p. */
+                    square_t ep = from + up;
+                    /* check that opponent can e.p. */
+                    if (bb_pawn_attacks[us][ep] & pos->bb[them][PAWN]) {
+                        pos->en_passant = ep;
+                        key ^= zobrist_ep[EP_ZOBRIST_IDX(ep)];
+                    }
+                }
+            }
+            key ^= zobrist_pieces[piece][from] ^ zobrist_pieces[piece][to];
+            score += pst_score[us][pt][to] - pst_score[us][pt][from];
+            pos_mv_sq(pos, from, to);
+            castle &= sq_castle[from];
+            /* do this always, cheaper than test on K move */
+            pos->king[us] = ctz64(pos->bb[us][KING]);
+            break;
+
+        case M_PROMOTION: {
+            piece_t promoted = MAKE_PIECE(move_promoted(move), us);
+
+            bug_on(sq_rank(to) != sq_rel_rank(RANK_8, us));
+            pos->clock_50 = 0;
+            if (captured != EMPTY) {
+                bug_on(COLOR(captured) != them);
+                key ^= zobrist_pieces[captured][to];
+                score += pst_score[them][PIECE(captured)][to];
+                pos->material -= zobrist_material[captured];
+                pos->phase += pt_phase[PIECE(captured)];
+                pos_clr_sq(pos, to);
+                castle &= sq_castle[to];
             }
-        } else if (is_enpassant(move)) {          /* e.p.: clear grabbed pawn */
+            key ^= zobrist_pieces[piece][from] ^ zobrist_pieces[promoted][to];
+            score += pst_score[us][PIECE(promoted)][to] - pst_score[us][PAWN][from];
+            pos->material += zobrist_material[promoted] - zobrist_material[piece];
+            pos->phase -= pt_phase[PIECE(promoted)] - pt_phase[PAWN];
+            pos_clr_sq(pos, from);
+            pos_set_sq(pos, to, promoted);
+            break;
+        }
+
+        case M_ENPASSANT: {                       /* clear grabbed pawn */
             square_t grabbed = to - up;
-            piece_t pc = pos->board[grabbed];
-            key ^= zobrist_pieces[pc][grabbed];
+
+            pos->clock_50 = 0;
+            key ^= zobrist_pieces[MAKE_PIECE(PAWN, them)][grabbed];
+            score += pst_score[them][PAWN][grabbed];
+            pos->material -= zobrist_material[MAKE_PIECE(PAWN, them)];
+            pos->phase += pt_phase[PAWN];
             pos_clr_sq(pos, grabbed);
+            key ^= zobrist_pieces[piece][from] ^ zobrist_pieces[piece][to];
+            score += pst_score[us][PAWN][to] - pst_score[us][PAWN][from];
+            pos_mv_sq(pos, from, to);
+            break;
         }
-    } else if (is_castle(move)) {                 /* castling: handle rook move */
-        square_t rookfrom, rookto;
-        if (to > from) {                          /* o-o */
-            rookfrom = to + 1;
-            rookto = to - 1;
-        } else {                                  /* o-o-o */
-            rookfrom = to - 2;
-            rookto = to + 1;
+
+        case M_CASTLE: {                          /* king and rook moves */
+            square_t rookfrom, rookto;
+            piece_t rook = MAKE_PIECE(ROOK, us);
+
+            if (to > from) {                      /* o-o */
+                rookfrom = to + 1;
+                rookto = to - 1;
+            } else {                              /* o-o-o */
+                rookfrom = to - 2;
+                rookto = to + 1;
+            }
+            key ^= zobrist_pieces[rook][rookfrom] ^ zobrist_pieces[rook][rookto];
+            pos_mv_sq(pos, rookfrom, rookto);
+            key ^= zobrist_pieces[piece][from] ^ zobrist_pieces[piece][to];
+            score += pst_score[us][ROOK][rookto] - pst_score[us][ROOK][rookfrom] +
+                pst_score[us][KING][to] - pst_score[us][KING][from];
+            pos_mv_sq(pos, from, to);
+            castle &= sq_castle[from];
+            pos->king[us] = to;
+            break;
         }
-        key ^= zobrist_pieces[pos->board[rookfrom]][rookto] ^
-            zobrist_pieces[pos->board[rookfrom]][rookfrom];
-        pos_set_sq(pos, rookto, pos->board[rookfrom]);
-        pos_clr_sq(pos, rookfrom);
     }
 
-    /* common part: captures and non captures
-     * We could improve slightly, as en-passant and double push will make
-     * the following tests.
-     * Improvement could be to add promotion test and king test twice above.
-     * (in capture and after ).
-     */
-    if (is_promotion(move)) {
-        bug_on(sq_rank(to) != sq_rel_rank(RANK_8, us));
-        new_piece = MAKE_PIECE(move_promoted(move), us);
+    /* update castling flags */
+    if (castle != pos->castle) {
+        key ^= zobrist_castling[pos->castle] ^ zobrist_castling[castle];
+        pos->castle = castle;
     }
 
-    key ^= zobrist_pieces[piece][from] ^ zobrist_pieces[new_piece][to];
-    pos_clr_sq(pos, from);
-    pos_set_sq(pos, to, new_piece);
+    pos->key = key;
+    /* material+PST values are white - black */
+    pos->psq += us == WHITE? score: -score;
 
-    /* update castling flags */
-    key ^= zobrist_castling[pos->castle];
-    pos->castle &= sq_castle[from] & sq_castle[to];
-    key ^= zobrist_castling[pos->castle];
+    zobrist_verify(pos);
 
-    //if (ptype == KING) {
-    //    pos->king[us] = to;
-    //} else
-    /* do this always, cheaper than test on K move */
-    pos->king[us] = ctz64(pos->bb[us][KING]);
+    pos_update_checkers_pinners_blockers(pos, move);
 
-    pos->key = key;
+    return pos;
+}
 
-    zobrist_verify(pos);
+/**
+ * move_do() - do move.
+ * @pos:    &pos_t position
+ * @move:   move to apply
+ * @state:  &state_t address where irreversible changes will be saved
+ *
+ * @move is applied to @pos:
+ * - bitboards and board are updated
+ * - counters are updated:
+ *   - move count
+ *   - 50-moves rule count
+ * - flags are possibly updated:
+ *   - castling
+ *   - en-passant
+ * - captured piece (excl. en-passant)
+ * - tt hash values are updated for:
+ *   - side-to-move
+ *   - en-passant
+ *   - castling rights.
+ * - material+PST midgame and endgame values, material key and game phase
+ *   are updated.
+ * - checkers, pinners and blockers are incrementally updated (they must be
+ *   valid before the move).
+ *
+ * @return: updated pos.
+ */
+pos_t *move_do(pos_t *pos, const move_t move, state_t *state)
+{
+    piece_t piece = pos->board[move_from(move)];
+    piece_t captured = pos->board[move_to(move)];
 
+    if (pos->turn == WHITE)
+        return _move_do(pos, move, piece, captured, state, WHITE);
+    return _move_do(pos, move, piece, captured, state, BLACK);
+}
+
+/**
+ * move_do_ext() - do move, extended move version.
+ * @pos:    &pos_t position
+ * @emove:  emove_t extended move to apply
+ * @state:  &state_t address where irreversible changes will be saved
+ *
+ * Same as move_do(), but moving and captured pieces are taken from @emove
+ * (see moves_extend()) instead of position board.
+ * Move is undone with move_undo(), with emove_move(@emove).
+ *
+ * @return: updated pos.
+ */
+pos_t *move_do_ext(pos_t *pos, const emove_t emove, state_t *state)
+{
+    move_t move = emove_move(emove);
+
+    if (pos->turn == WHITE)
+        return _move_do(pos, move, emove_piece(emove), emove_captured(emove),
+                        state, WHITE);
+    return _move_do(pos, move, emove_piece(emove), emove_captured(emove),
+                    state, BLACK);
+}
+
+/**
+ * move_do_copy() - do move on a copy of position (copy-make).
+ * @pos:    &pos_t source position
+ * @move:   move_t move to apply
+ * @next:   &pos_t destination position
+ *
+ * Copy @pos hot part (see POS_COPY_SIZE) into @next, then do @move on @next,
+ * as move_do() would. @pos is left untouched, there is nothing to undo: The
+ * previous position is simply @pos.
+ * @next is usually the next slot of a per-ply positions stack. Other @next
+ * fields (eval, check info, node count) are not set.
+ *
+ * @return: @next.
+ */
+pos_t *move_do_copy(const pos_t *pos, const move_t move, pos_t *next)
+{
+    piece_t piece = pos->board[move_from(move)];
+    piece_t captured = pos->board[move_to(move)];
+
+    memcpy(next, pos, POS_COPY_SIZE);
+    if (pos->turn == WHITE)
+        return _move_do(next, move, piece, captured, NULL, WHITE);
+    return _move_do(next, move, piece, captured, NULL, BLACK);
+}
+
+/**
+ * _move_undo() - undo move, for a constant color.
+ * @us: color which played the move
+ *
+ * See move_undo().
+ */
+static __always_inline pos_t *_move_undo(pos_t *pos, const move_t move,
+                                         const state_t *state, const color_t us)
+{
+    color_t them = OPPONENT(us);
+    square_t from = move_from(move), to = move_to(move);
+    piece_t captured = pos->captured;
+
+    switch (move_flags(move)) {
+        case M_NORMAL:
+            pos_mv_sq(pos, to, from);
+            if (captured != EMPTY)                /* restore captured piece */
+                pos_set_sq(pos, to, captured);
+            break;
+
+        case M_PROMOTION:
+            pos_clr_sq(pos, to);
+            pos_set_sq(pos, from, MAKE_PIECE(PAWN, us));
+            if (captured != EMPTY)
+                pos_set_sq(pos, to, captured);
+            break;
+
+        case M_ENPASSANT:                         /* restore grabbed pawn */
+            pos_mv_sq(pos, to, from);
+            pos_set_sq(pos, to - sq_up(us), MAKE_PIECE(PAWN, them));
+            break;
+
+        case M_CASTLE: {                          /* king and rook moves */
+            square_t rookfrom, rookto;
+
+            if (to > from) {                      /* o-o */
+                rookfrom = to - 1;
+                rookto = to + 1;
+            } else {                              /* o-o-o */
+                rookfrom = to + 1;
+                rookto = to - 2;
+            }
+            pos_mv_sq(pos, to, from);
+            pos_mv_sq(pos, rookfrom, rookto);
+            break;
+        }
+    }
+
+    pos->state = *state;                          /* restore irreversible changes */
     return pos;
 }
 
@@ -167,6 +334,7 @@ pos_t *move_do(pos_t *pos, const move_t move, state_t *state)
  * @move is applied to @pos:
  * - bitboards and board are updated
  * - previous information is restored:
+ *   - side to move and kings squares
  *   - castling
  *   - en-passant
  *   - captured piece (excl. en-passant)
@@ -177,51 +345,9 @@ pos_t *move_do(pos_t *pos, const move_t move, state_t *state)
  */
 pos_t *move_undo(pos_t *pos, const move_t move, const state_t *state)
 {
-    color_t them = pos->turn, us = OPPONENT(them);
-    square_t from = move_from(move), to = move_to(move);
-    piece_t piece = pos->board[to];
-    int up = sq_up(them);
-
-    /* common part: captures and non captures
-     * We could improve slightly, as en-passant and double push will make
-     * the following tests.
-     * Improvement could be to add promotion test and king test twice above.
-     * (in capture and after ).
-     */
-    if (is_promotion(move))
-        piece = MAKE_PIECE(PAWN, us);
-
-    pos_clr_sq(pos, to);
-    pos_set_sq(pos, from, piece);
-
-    /* special moves: capture, king (+ castling), en-passant
-     */
-    if (pos->captured != EMPTY) {                 /* captured: restore piece */
-        pos_set_sq(pos, to, pos->captured);
-    } else if (is_castle(move)) {                 /* castle: rook move */
-        square_t rookfrom, rookto;
-        if (to > from) {                          /* o-o */
-            rookfrom = to - 1;
-            rookto = to + 1;
-        } else {                                  /* o-o-o */
-            rookfrom = to + 1;
-            rookto = to - 2;
-        }
-        pos_set_sq(pos, rookto, pos->board[rookfrom]);
-        pos_clr_sq(pos, rookfrom);
-    } else if (is_enpassant(move)) {              /* e.p.: restore grabbed pawn */
-        square_t grabbed = to + up;
-        pos_set_sq(pos, grabbed, MAKE_PIECE(PAWN, them));
-    }
-
-    /* do this always, cheaper than test on K move */
-    pos->king[us] = ctz64(pos->bb[us][KING]);
-    //if (PIECE(piece) == KING)
-    //    pos->king[us] = from;
-
-    pos->state = *state;                          /* restore irreversible changes */
-    pos->turn = us;
-    return pos;
+    if (pos->turn == WHITE)                       /* black move to undo */
+        return _move_undo(pos, move, state, BLACK);
+    return _move_undo(pos, move, state, WHITE);
 }
 
 /**
@@ -21,6 +21,8 @@ extern castle_rights_t sq_castle[64];             /* to adjust castling rights *
 
 pos_t *move_do(pos_t *pos, const move_t move, state_t *state);
 pos_t *move_undo(pos_t *pos, const move_t move, const state_t *state);
+pos_t *move_do_ext(pos_t *pos, const emove_t emove, state_t *state);
+pos_t *move_do_copy(const pos_t *pos, const move_t move, pos_t *next);
 
 /* new version testing */
 pos_t *move_do_alt(pos_t *pos, const move_t move, state_t *state);
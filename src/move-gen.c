@@ -12,6 +12,9 @@
  */
 
 #include <stdio.h>
+#ifdef __AVX512VBMI2__
+#include <immintrin.h>
+#endif
 
 #include "bitops.h"
 #include "bug.h"
@@ -27,15 +30,51 @@
 #include "move-gen.h"
 
 /**
- * pseudo_is_legal() - check if a move is legal.
+ * king_to_is_attacked() - check if a king destination square is attacked
+ * @pos:  position
+ * @to:   king destination square
+ * @us:   king color (player-to-move)
+ *
+ * The king is excluded from occupation, to catch king moving away from a
+ * slider checker on the same line.
+ * pos->checkers must be valid.
+ *
+ * @return: true if @to is attacked by opponent, false otherwise.
+ */
+static __always_inline bool king_to_is_attacked(const pos_t *pos, const square_t to,
+                                                const color_t us)
+{
+    color_t them = OPPONENT(us);
+    square_t king = pos->king[us];
+
+#ifdef POS_ATTACKS
+    bitboard_t sliders = pos->checkers & ~BIT(to) &
+        ~(pos->bb[them][PAWN] | pos->bb[them][KNIGHT]);
+
+    if (pos->attackers[to] & pos->bb[them][ALL_PIECES])
+        return true;
+    /* @to is behind the king, on a slider checker line */
+    while (sliders)
+        if (bb_line(bb_next(&sliders), king) & BIT(to))
+            return true;
+    return false;
+#else
+    return sq_is_attacked(pos, pos_occ(pos) ^ BIT(king), to, them);
+#endif
+}
+
+/**
+ * is_legal() - check if a move is legal, for a constant color.
  * @pos:  position
  * @move: move_t to verify
+ * @us:   player-to-move color
+ *
+ * See pseudo_is_legal().
  *
  * @return: true if move is valid, false otherwise.
  */
-bool pseudo_is_legal(const pos_t *pos, const move_t move)
+static __always_inline bool is_legal(const pos_t *pos, const move_t move, const color_t us)
 {
-    color_t  us       = pos->turn;
     color_t them      = OPPONENT(us);
     square_t from     = move_from(move);
     square_t to       = move_to(move);
@@ -60,7 +99,7 @@ bool pseudo_is_legal(const pos_t *pos, const move_t move)
             return false;
     }
     if (from == kingsq) {
-        return !sq_is_attacked(pos, occ ^ kingbb, to, them);
+        return !king_to_is_attacked(pos, to, us);
     }
 
     /* (2) - King is in check
@@ -83,7 +122,7 @@ bool pseudo_is_legal(const pos_t *pos, const move_t move)
      * We verify here that pinned piece P stays on line between K & dest square.
      */
     if (pinned) {
-        return bb_line[from][kingsq] & BIT(to);   /* is to on pinner line ? */
+        return bb_line(from, kingsq) & BIT(to);   /* is to on pinner line ? */
     }
 
     /* (4) - En-passant
@@ -105,6 +144,184 @@ bool pseudo_is_legal(const pos_t *pos, const move_t move)
     return true;
 }
 
+/**
+ * pseudo_is_legal() - check if a move is legal.
+ * @pos:  position
+ * @move: move_t to verify
+ *
+ * @return: true if move is valid, false otherwise.
+ */
+bool pseudo_is_legal(const pos_t *pos, const move_t move)
+{
+    return pos->turn == WHITE? is_legal(pos, move, WHITE): is_legal(pos, move, BLACK);
+}
+
+/**
+ * move_is_pseudo_legal() - check if a move is pseudo-legal.
+ * @pos:  position
+ * @move: any move_t to verify
+ *
+ * Find if @move, which may come from any source (transposition table, killer
+ * moves...), is one of the moves which would be generated by pos_gen_pseudo()
+ * in @pos. pseudo_is_legal() can then be used to verify its legality, without
+ * generating all position moves.
+ *
+ * Like in generation, when king is in check only king moves (double check), or
+ * moves to check evasion squares and en-passant, are accepted.
+ * Position checkers must be set before calling this function.
+ *
+ * @return: true if move is pseudo-legal, false otherwise.
+ */
+bool move_is_pseudo_legal(const pos_t *pos, const move_t move)
+{
+    color_t us       = pos->turn;
+    square_t from    = move_from(move);
+    square_t to      = move_to(move);
+    square_t king    = pos->king[us];
+    piece_t pc       = pos->board[from];
+    piece_type_t pt  = PIECE(pc);
+    bitboard_t occ   = pos_occ(pos);
+    bitboard_t tobb  = BIT(to);
+    bitboard_t checkers = pos->checkers;
+    int up           = sq_up(us);
+    int flags        = move_flags(move);
+
+    /* also catches MOVE_NONE and MOVE_NULL (from == to) */
+    if (pc == EMPTY || COLOR(pc) != us || tobb & pos->bb[us][ALL_PIECES])
+        return false;
+    if (flags != M_PROMOTION && move & M_PROMOTED_MASK)
+        return false;
+
+    switch (flags) {
+        case M_CASTLE: {
+            bitboard_t rel_rank1 = bb_rel_rank(RANK_1, us);
+
+            if (from != king || checkers)
+                return false;
+            if (to == from + 2)
+                return can_oo(pos->castle, us) &&
+                    !(occ & rel_rank1 & (FILE_Fbb | FILE_Gbb));
+            if (to == from - 2)
+                return can_ooo(pos->castle, us) &&
+                    !(occ & rel_rank1 & (FILE_Bbb | FILE_Cbb | FILE_Dbb));
+            return false;
+        }
+        case M_ENPASSANT:
+            return pt == PAWN && to == pos->en_passant &&
+                bb_pawn_attacks[us][from] & tobb && !bb_multiple(checkers);
+    }
+
+    if (pt == PAWN) {
+        /* promotion flag must match destination rank */
+        if (!(tobb & bb_rel_rank(RANK_8, us)) != (flags != M_PROMOTION))
+            return false;
+        if (!(bb_pawn_attacks[us][from] & tobb & occ) &&    /* capture */
+            !(to == from + up && !(tobb & occ)) &&          /* push */
+            !(to == from + up + up && BIT(from) & bb_rel_rank(RANK_2, us) &&
+              !(occ & (BIT(from + up) | tobb))))              /* double push */
+            return false;
+    } else {
+        bitboard_t attacks;
+
+        if (flags == M_PROMOTION)
+            return false;
+        switch (pt) {
+            case KNIGHT:
+                attacks = bb_knight[from];
+                break;
+            case BISHOP:
+                attacks = hq_bishop_moves(occ, from);
+                break;
+            case ROOK:
+                attacks = hq_rook_moves(occ, from);
+                break;
+            case QUEEN:
+                attacks = hq_queen_moves(occ, from);
+                break;
+            default:                              /* king: no restriction */
+                return bb_king[from] & tobb;
+        }
+        if (!(attacks & tobb))
+            return false;
+    }
+
+    /* in check: non-king moves must capture checker or interpose */
+    if (checkers) {
+        if (bb_multiple(checkers))
+            return false;
+        return (bb_between(king, ctz64(checkers)) | checkers) & tobb;
+    }
+    return true;
+}
+
+/**
+ * move_gives_check() - check if a move gives check.
+ * @pos:  position
+ * @move: legal move_t to verify
+ *
+ * Find if @move, played in @pos, would give check to opponent king, without
+ * doing the move.
+ * Position check info must be set (see pos_set_check_info()).
+ *
+ * @return: true if move gives check, false otherwise.
+ */
+bool move_gives_check(const pos_t *pos, const move_t move)
+{
+    color_t us       = pos->turn;
+    square_t from    = move_from(move);
+    square_t to      = move_to(move);
+    square_t oking   = pos->king[OPPONENT(us)];
+    piece_type_t pt  = PIECE(pos->board[from]);
+    bitboard_t occ   = pos_occ(pos);
+
+    bug_on(pos->board[from] == NO_PIECE || COLOR(pos->board[from]) != us);
+
+    /* (1) - direct check (promotion is handled below) */
+    if (pos->check_squares[pt] & BIT(to))
+        return true;
+
+    /* (2) - discovered check: piece leaves the line between our slider
+     * and opponent king.
+     */
+    if (pos->discovery & BIT(from) && !(bb_line(from, oking) & BIT(to)))
+        return true;
+
+    switch (move_flags(move)) {
+        case M_PROMOTION:
+            /* pawn left @from: line through it may be opened */
+            occ ^= BIT(from);
+            switch (move_promoted(move)) {
+                case KNIGHT:
+                    return bb_knight[to] & BIT(oking);
+                case BISHOP:
+                    return hq_bishop_moves(occ, to) & BIT(oking);
+                case ROOK:
+                    return hq_rook_moves(occ, to) & BIT(oking);
+                default:
+                    return hq_queen_moves(occ, to) & BIT(oking);
+            }
+        case M_ENPASSANT: {
+            /* the two pawns "disappearing" may discover a check */
+            bitboard_t rooks   = pos->bb[us][ROOK] | pos->bb[us][QUEEN];
+            bitboard_t bishops = pos->bb[us][BISHOP] | pos->bb[us][QUEEN];
+
+            occ ^= BIT(from) | BIT(to) | BIT(to - sq_up(us));
+            return (hq_rook_moves(occ, oking) & rooks) ||
+                (hq_bishop_moves(occ, oking) & bishops);
+        }
+        case M_CASTLE: {
+            /* rook final square is the square crossed by king */
+            square_t rookfrom = to > from? to + 1: to - 2;
+            square_t rookto   = to > from? to - 1: to + 1;
+
+            occ ^= BIT(from) | BIT(to) | BIT(rookfrom) | BIT(rookto);
+            return hq_rook_moves(occ, rookto) & BIT(oking);
+        }
+        default:
+            return false;
+    }
+}
+
 /**
  * pos_next_legal() - get next legal move in position.
  * @pos:  position
@@ -123,11 +340,19 @@ move_t pos_next_legal(const pos_t *pos, movelist_t *movelist, int *start)
     const move_t *moves = movelist->move;
     move_t move;
 
-    while (*start < nmoves) {
-        if (pseudo_is_legal(pos, (move = moves[(*start)++] )))
-            return  move;
-    }
+#define next_legal(us) do {                                             \
+        while (*start < nmoves) {                                       \
+            if (is_legal(pos, (move = moves[(*start)++] ), us))         \
+                return  move;                                           \
+        }                                                               \
+    } while (0)
+
+    if (pos->turn == WHITE)
+        next_legal(WHITE);
+    else
+        next_legal(BLACK);
     return MOVE_NONE;
+#undef next_legal
 }
 
 /**
@@ -168,85 +393,24 @@ movelist_t *pos_legal(const pos_t *pos, movelist_t *list)
 {
     move_t *cur = list->move, *last = list->move + list->nmoves;
 
-    while (cur < last) {
-        if (pseudo_is_legal(pos, *cur))
-            cur++;
-        else {
-            *cur = *--last;
-        }
-    }
+#define filter_legal(us) do {                                           \
+        while (cur < last) {                                            \
+            if (is_legal(pos, *cur, us))                                \
+                cur++;                                                  \
+            else                                                        \
+                *cur = *--last;                                         \
+        }                                                               \
+    } while (0)
+
+    if (pos->turn == WHITE)
+        filter_legal(WHITE);
+    else
+        filter_legal(BLACK);
+#undef filter_legal
     list->nmoves = last - list->move;
     return list;
 }
 
-/**
- * gen_pseudo_king() - generate king pseudo-legal moves.
- * @pos: position
- * @movelist: &movelist_t array to store pseudo-moves
- *
- */
-static inline __unused move_t *gen_pseudo_king(move_t *moves, square_t from,
-                                               bitboard_t mask)
-{
-    //color_t us    = pos->turn;
-    //square_t from = pos->king[us];
-    //bitboard_t not_my_pieces     = ~pos->bb[us][ALL_PIECES];
-    bitboard_t to_bb = bb_king_moves(mask, from);
-    square_t to;
-    while (moves) {
-        to = bb_next(&to_bb);
-        *moves++ = move_make(from, to);
-    }
-    return moves;
-}
-
-/**
- * pos_gen_check_pseudomoves() - generate position pseudo-legal moves when in check
- * @pos: position
- * @movelist: &movelist_t array to store pseudo-moves
- *
- * Generate all @pos pseudo moves for player-to-move.
- * @movelist is filled with the moves.
- *
- * Only a few validity checks are done here (i.e. moves are not generated):
- *  - castling, if king is in check
- *  - castling, if king passes an enemy-controlled square (not final square).
- * When immediately known, a few move flags are also applied in these cases:
- *  - castling: M_CASTLE
- *  - en-passant: M_EN_PASSANT
- *  - promotion: M_PROMOTION
- *
- * TODO: move code to specific functions (especially castling, pawn push/capture)
- *
- * @Return: The total number of moves.
- */
-
-/**
- * gen_pseudo_escape() - generate position pseudo-legal moves when in check
- * @pos: square_t king position
- * @mask: possible destinations to consider
- * @moves: &move_t array to store pseudo-moves
- *
- * Generate all @pos pseudo moves for player-to-move, when in check.
- * @movelist is filled with the moves.
- *
- * If king is doubles-checked, only King moves will be generated.
- * Otherwise, only moves where destination in between King or checker, or checker
- * square.
- *
- */
-/*
- * static void __always_inline gen_pseudo_escape(pos_t *pos, movelist_t *movelist)
- * {
- *     color_t us               = pos->turn;
- *     color_t them             = OPPONENT(us);
- *     square_t king            = pos->king[us];
- *
- *     gen_pseudo_king(pos, movelist);
- *
- * }
- */
-
 /**
  * moves_gen_flags() - generate all moves from square to bitboard (with flags).
  * @moves: &move_t array where to store moves
@@ -272,26 +436,64 @@ static inline __unused move_t *moves_gen_flags(move_t *moves, square_t from,
 }
 
 /**
- * move_gen_promotions() - generate all promotions for given pawn and dest.
+ * move_gen_promotions() - generate promotions for given pawn and dest.
  * @moves: &move_t array where to store moves
  * @from: pawn position
  * @to: promotion square
+ * @type: generation type
  *
- * Generate  (at address @moves) all promotion (Q/R/B/N) moves on @to for
- * pawn @from.
+ * Generate  (at address @moves) promotion moves on @to for pawn @from.
+ * Queen promotions are considered as captures (GEN_CAPTURES), and
+ * under-promotions as quiet moves (GEN_QUIETS). Other generation types
+ * generate all promotions (Q/R/B/N).
  * Actual promoted piece type is encoded as piece - 2, i.e. N = 0, B = 1,
  * R = 2, Q = 3.
  *
  * @Return: New @moves.
  */
-static inline move_t *move_gen_promotions(move_t *moves, square_t from, square_t to)
+static __always_inline move_t *move_gen_promotions(move_t *moves, square_t from,
+                                                   square_t to, const gen_type_t type)
 {
-    /* your attention: "downto operator" */
-    for (piece_type_t pt = QUEEN - 1; pt --> KNIGHT - 2;)
-        *moves++ = move_make_promote(from, to, pt);
+    if (type != GEN_QUIETS)
+        *moves++ = move_make_promote(from, to, QUEEN - 2);
+    if (type != GEN_CAPTURES) {
+        /* your attention: "downto operator" */
+        for (piece_type_t pt = ROOK - 1; pt --> KNIGHT - 2;)
+            *moves++ = move_make_promote(from, to, pt);
+    }
     return moves;
 }
 
+#ifdef __AVX512VBMI2__
+/* all squares, as 16 bits vector elements, for moves serialization */
+#define _SQ8(r) r*8+0, r*8+1, r*8+2, r*8+3, r*8+4, r*8+5, r*8+6, r*8+7
+static const u16 sq_vec[64] __attribute__((aligned(64))) = {
+    _SQ8(0), _SQ8(1), _SQ8(2), _SQ8(3), _SQ8(4), _SQ8(5), _SQ8(6), _SQ8(7)
+};
+#undef _SQ8
+
+/**
+ * moves_store() - store moves for destination bitboard (AVX-512 VBMI2).
+ * @moves: &move_t array where to store moves
+ * @to_bb: destination bitboard
+ * @lo:    moves for destination squares 0-31 (one per 16 bits element)
+ * @hi:    moves for destination squares 32-63
+ *
+ * Store (at address @moves) @lo and @hi moves which destination square is
+ * in @to_bb, with a compress-store.
+ *
+ * @Return: New @moves.
+ */
+static __always_inline move_t *moves_store(move_t *moves, bitboard_t to_bb,
+                                           __m512i lo, __m512i hi)
+{
+    _mm512_mask_compressstoreu_epi16(moves, (__mmask32) to_bb, lo);
+    moves += popcount64(to_bb & 0xffffffff);
+    _mm512_mask_compressstoreu_epi16(moves, (__mmask32) (to_bb >> 32), hi);
+    return moves + popcount64(to_bb >> 32);
+}
+#endif
+
 /**
  * moves_gen() - generate all moves from square to bitboard.
  * @moves: &move_t array where to store moves
@@ -299,11 +501,21 @@ static inline move_t *move_gen_promotions(move_t *moves, square_t from, square_t
  * @to_bb: destination bitboard
  *
  * Generate (at address @moves) moves from square @from to each square in @to_bb.
+ * With AVX-512 VBMI2, all moves are built and stored at once.
  *
  * @Return: New @moves.
  */
 static inline move_t *moves_gen(move_t *moves, square_t from, bitboard_t to_bb)
 {
+#ifdef __AVX512VBMI2__
+    __m512i vfrom = _mm512_set1_epi16(from);
+    __m512i lo = _mm512_load_si512(sq_vec);
+    __m512i hi = _mm512_load_si512(sq_vec + 32);
+
+    lo = _mm512_or_si512(_mm512_slli_epi16(lo, M_OFF_TO), vfrom);
+    hi = _mm512_or_si512(_mm512_slli_epi16(hi, M_OFF_TO), vfrom);
+    return moves_store(moves, to_bb, lo, hi);
+#else
     square_t to;
     // bb_print(sq_to_string(from), to_bb);
     while(to_bb) {
@@ -311,33 +523,495 @@ static inline move_t *moves_gen(move_t *moves, square_t from, bitboard_t to_bb)
         *moves++ = move_make(from, to);
     }
     return moves;
+#endif
 }
 
 /**
- * pos_gen_pseudo() - generate position pseudo-legal moves
+ * moves_gen_shift() - generate all moves to bitboard, from shifted squares.
+ * @moves: &move_t array where to store moves
+ * @to_bb: destination bitboard
+ * @shift: difference between destination and origin squares
+ *
+ * Generate (at address @moves) moves to each square in @to_bb, from square
+ * (to - @shift). Used for pawns pushes.
+ * With AVX-512 VBMI2, all moves are built and stored at once.
+ *
+ * @Return: New @moves.
+ */
+static inline move_t *moves_gen_shift(move_t *moves, bitboard_t to_bb, int shift)
+{
+#ifdef __AVX512VBMI2__
+    __m512i vshift = _mm512_set1_epi16(shift);
+    __m512i lo = _mm512_load_si512(sq_vec);
+    __m512i hi = _mm512_load_si512(sq_vec + 32);
+
+    lo = _mm512_or_si512(_mm512_slli_epi16(lo, M_OFF_TO), _mm512_sub_epi16(lo, vshift));
+    hi = _mm512_or_si512(_mm512_slli_epi16(hi, M_OFF_TO), _mm512_sub_epi16(hi, vshift));
+    return moves_store(moves, to_bb, lo, hi);
+#else
+    square_t to;
+    while(to_bb) {
+        to = bb_next(&to_bb);
+        *moves++ = move_make(to - shift, to);
+    }
+    return moves;
+#endif
+}
+
+/**
+ * gen_evasions() - generate position legal moves when in check.
  * @pos: position
- * @movelist: &movelist_t array to store pseudo-moves
+ * @moves: &move_t array to store moves
+ * @us: player-to-move color
  *
- * Generate all @pos pseudo moves for player-to-move.
- * @movelist is filled with the moves.
+ * Generate all @pos legal moves for player-to-move, when king is in check.
+ * Generated moves are:
+ *  - king moves to non-attacked squares.
+ *  - if only one checker, non-pinned pieces moves capturing the checker or
+ *    interposing between checker and king (including en-passant, if the
+ *    grabbed pawn is the checker).
+ * Pinned pieces are never considered: They cannot leave the pin line, which
+ * cannot contain the checker or a square between checker and king.
  *
- * Only a few validity checks are done here (i.e. moves are not generated):
- *  - castling, if king is in check
- *  - castling, if king passes an enemy-controlled square (not final square).
- * When immediately known, a few move flags are also applied in these cases:
- *  - castling: M_CASTLE_{K,Q}
- *  - capture (excl. en-passant): M_CAPTURE
- *  - en-passant: M_EN_PASSANT
- *  - promotion: M_PROMOTION
- *  - promotion and capture
+ * @Return: New @moves.
+ */
+static __always_inline move_t *gen_evasions(pos_t *pos, move_t *moves, const color_t us)
+{
+    color_t them             = OPPONENT(us);
+    square_t king            = pos->king[us];
+    bitboard_t my_pieces     = pos->bb[us][ALL_PIECES];
+    bitboard_t occ           = my_pieces | pos->bb[them][ALL_PIECES];
+    bitboard_t empty         = ~occ;
+    bitboard_t checkers      = pos->checkers;
+    bitboard_t movable       = my_pieces & ~pos->blockers;
+    bitboard_t from_bb, to_bb, tmp_bb, target;
+    square_t from, to, checker;
+
+    bug_on(!checkers);
+
+    /* king: we remove it from occupation, to catch moves away from a slider
+     * checker on the same line.
+     */
+    to_bb = bb_king_moves(~my_pieces, king);
+    while (to_bb) {
+        to = bb_next(&to_bb);
+        if (!king_to_is_attacked(pos, to, us))
+            *moves++ = move_make(king, to);
+    }
+
+    if (bb_multiple(checkers))                    /* double check, we stop here */
+        return moves;
+
+    /* one checker: destination squares are between checker and king
+     * (interposition) and checker square (capture).
+     */
+    checker = ctz64(checkers);
+    target  = bb_between(king, checker) | checkers;
+
+    /* sliding pieces */
+    from_bb = (pos->bb[us][BISHOP] | pos->bb[us][QUEEN]) & movable;
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        moves = moves_gen(moves, from, hq_bishop_moves(occ, from) & target);
+    }
+    from_bb = (pos->bb[us][ROOK] | pos->bb[us][QUEEN]) & movable;
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        moves = moves_gen(moves, from, hq_rook_moves(occ, from) & target);
+    }
+
+    /* knight */
+    from_bb = pos->bb[us][KNIGHT] & movable;
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        moves = moves_gen(moves, from, bb_knight_moves(target, from));
+    }
+
+    /* pawn: push (interposition only) */
+    bitboard_t pawns     = pos->bb[us][PAWN] & movable;
+    bitboard_t rel_rank8 = bb_rel_rank(RANK_8, us);
+    bitboard_t rel_rank3 = bb_rel_rank(RANK_3, us);
+    int shift = sq_up(us);
+
+    tmp_bb = bb_shift(pawns, shift) & empty;
+    to_bb = bb_shift(tmp_bb & rel_rank3, shift) & empty & target;
+    moves = moves_gen_shift(moves, to_bb, shift + shift);   /* double push */
+    moves = moves_gen_shift(moves, tmp_bb & target & ~rel_rank8, shift);
+    to_bb = tmp_bb & target & rel_rank8;
+    while (to_bb) {
+        to = bb_next(&to_bb);
+        moves = move_gen_promotions(moves, to - shift, to, GEN_ALL);
+    }
+
+    /* pawn: checker capture */
+    from_bb = bb_pawn_attacks[them][checker] & pawns;
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        if (checkers & rel_rank8)
+            moves = move_gen_promotions(moves, from, checker, GEN_ALL);
+        else
+            *moves++ = move_make(from, checker);
+    }
+
+    /* pawn: en-passant, only if grabbed pawn is the checker.
+     * En-passant cannot discover a check here: The grabbed pawn is
+     * adjacent to our king, and the capturing pawn is not pinned.
+     */
+    if ((to = pos->en_passant) != SQUARE_NONE && to + sq_up(them) == checker) {
+        from_bb = bb_pawn_attacks[them][to] & pawns;
+        while (from_bb) {
+            from = bb_next(&from_bb);
+            *moves++ = move_make_enpassant(from, to);
+        }
+    }
+    return moves;
+}
+
+/**
+ * gen_legal() - generate position legal moves when not in check.
+ * @pos: position
+ * @moves: &move_t array to store moves
+ * @us: player-to-move color
  *
- * TODO: move code to specific functions (especially castling, pawn push/capture)
+ * Generate all @pos legal moves for player-to-move, when king is not in check.
+ * Legality is ensured at generation time:
+ *  - King moves and castling use the opponent attack map, calculated once.
+ *  - Pinned pieces (position blockers) are restricted to their pin line.
+ *  - En-passant (rare) is verified with pseudo_is_legal().
  *
- * @Return: movelist
+ * @Return: New @moves.
  */
-movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
+static __always_inline move_t *gen_legal(pos_t *pos, move_t *moves, const color_t us)
+{
+    color_t them             = OPPONENT(us);
+    square_t king            = pos->king[us];
+    bitboard_t my_pieces     = pos->bb[us][ALL_PIECES];
+    bitboard_t enemy_pieces  = pos->bb[them][ALL_PIECES];
+    bitboard_t dest_squares  = ~my_pieces;
+    bitboard_t occ           = my_pieces | enemy_pieces;
+    bitboard_t empty         = ~occ;
+    bitboard_t pinned        = pos->blockers & my_pieces;
+    bitboard_t attacked      = pos_attacks(pos, occ ^ BIT(king), them);
+    bitboard_t from_bb, to_bb, tmp_bb;
+    square_t from, to;
+
+    bug_on(pos->checkers);
+
+    /* king */
+    moves = moves_gen(moves, king, bb_king[king] & dest_squares & ~attacked);
+
+    /* castling: Attention ! Castling flags are assumed correct */
+    bitboard_t rel_rank1 = bb_rel_rank(RANK_1, us);
+    if (can_oo(pos->castle, us)) {
+        bitboard_t occmask = rel_rank1 & (FILE_Fbb | FILE_Gbb);
+        if (!((occ | attacked) & occmask))
+            *moves++ = move_make_flags(king, king + 2, M_CASTLE);
+    }
+    if (can_ooo(pos->castle, us)) {
+        bitboard_t occmask = rel_rank1 & (FILE_Bbb | FILE_Cbb | FILE_Dbb);
+        bitboard_t attmask = rel_rank1 & (FILE_Cbb | FILE_Dbb);
+        if (!(occ & occmask) && !(attacked & attmask))
+            *moves++ = move_make_flags(king, king - 2, M_CASTLE);
+    }
+
+    /* sliding pieces: pinned ones stay on pin line */
+    from_bb = pos->bb[us][BISHOP] | pos->bb[us][QUEEN];
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        to_bb = hq_bishop_moves(occ, from) & dest_squares;
+        if (BIT(from) & pinned)
+            to_bb &= bb_line(from, king);
+        moves = moves_gen(moves, from, to_bb);
+    }
+    from_bb = pos->bb[us][ROOK] | pos->bb[us][QUEEN];
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        to_bb = hq_rook_moves(occ, from) & dest_squares;
+        if (BIT(from) & pinned)
+            to_bb &= bb_line(from, king);
+        moves = moves_gen(moves, from, to_bb);
+    }
+
+    /* knight: a pinned knight cannot move */
+    from_bb = pos->bb[us][KNIGHT] & ~pinned;
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        moves = moves_gen(moves, from, bb_knight[from] & dest_squares);
+    }
+
+    /* pawn: relative rank and files */
+    bitboard_t pawns     = pos->bb[us][PAWN];
+    bitboard_t rel_rank8 = bb_rel_rank(RANK_8, us);
+    bitboard_t rel_rank3 = bb_rel_rank(RANK_3, us);
+    int shift = sq_up(us);
+
+    /* pawn: push. Pinned pawns can only push if pinned on king file */
+    tmp_bb = bb_shift(pawns & (~pinned | bb_sqfile[king]), shift) & empty;
+    moves = moves_gen_shift(moves, tmp_bb & ~rel_rank8, shift);
+    to_bb = bb_shift(tmp_bb & rel_rank3, shift) & empty;
+    moves = moves_gen_shift(moves, to_bb, shift + shift);
+    to_bb = tmp_bb & rel_rank8;
+    while (to_bb) {
+        to = bb_next(&to_bb);
+        moves = move_gen_promotions(moves, to - shift, to, GEN_ALL);
+    }
+
+    /* pawn: captures by non-pinned pawns */
+    to_bb = bb_pawns_attacks(pawns & ~pinned, shift) & enemy_pieces;
+    while (to_bb) {
+        to = bb_next(&to_bb);
+        from_bb = bb_pawn_attacks[them][to] & pawns & ~pinned;
+        while (from_bb) {
+            from = bb_next(&from_bb);
+            if (BIT(to) & rel_rank8)
+                moves = move_gen_promotions(moves, from, to, GEN_ALL);
+            else
+                *moves++ = move_make(from, to);
+        }
+    }
+
+    /* pawn: captures by pinned pawns, only the pinner on pin diagonal */
+    from_bb = pawns & pinned & ~bb_sqfile[king];
+    while (from_bb) {
+        from = bb_next(&from_bb);
+        to_bb = bb_pawn_attacks[us][from] & enemy_pieces & bb_line(from, king);
+        while (to_bb) {
+            to = bb_next(&to_bb);
+            if (BIT(to) & rel_rank8)
+                moves = move_gen_promotions(moves, from, to, GEN_ALL);
+            else
+                *moves++ = move_make(from, to);
+        }
+    }
+
+    /* pawn: en-passant */
+    if ((to = pos->en_passant) != SQUARE_NONE) {
+        from_bb = bb_pawn_attacks[them][to] & pawns;
+        while (from_bb) {
+            move_t move = move_make_enpassant(bb_next(&from_bb), to);
+            if (is_legal(pos, move, us))
+                *moves++ = move;
+        }
+    }
+    return moves;
+}
+
+/**
+ * has_legal_move() - check if player-to-move has at least one legal move.
+ * @pos: position
+ * @us: player-to-move color
+ *
+ * Cheapest candidates are tried first, and we return on first legal move:
+ *  - Non-pinned knights and pawns, as sets, to any square (or, when in single
+ *    check, to checker or interposition squares).
+ *  - King moves to non-attacked squares. Castling is never needed, as it
+ *    implies a legal king move.
+ *  - Non-pinned sliders, same destinations as knights and pawns.
+ *  - Pinned pieces along their pin line (not in check only).
+ *  - En-passant, verified with is_legal().
+ * In double check, only king moves are considered.
+ *
+ * @Return: true if a legal move exists, false otherwise.
+ */
+static __always_inline bool has_legal_move(const pos_t *pos, const color_t us)
+{
+    color_t them             = OPPONENT(us);
+    square_t king            = pos->king[us];
+    bitboard_t my_pieces     = pos->bb[us][ALL_PIECES];
+    bitboard_t enemy_pieces  = pos->bb[them][ALL_PIECES];
+    bitboard_t occ           = my_pieces | enemy_pieces;
+    bitboard_t empty         = ~occ;
+    bitboard_t checkers      = pos->checkers;
+    bitboard_t pinned        = pos->blockers & my_pieces;
+    bitboard_t movable       = my_pieces & ~pinned;
+    bitboard_t target        = ~my_pieces;
+    bitboard_t from_bb, to_bb, pawns;
+    square_t from, to;
+    int shift = sq_up(us);
+
+    if (checkers) {
+        if (bb_multiple(checkers))                /* double check: king only */
+            movable = 0;
+        else
+            target = bb_between(king, ctz64(checkers)) | checkers;
+    }
+
+    /* knights */
+    if (bb_knights_attacks(pos->bb[us][KNIGHT] & movable) & target)
+        return true;
+
+    /* pawns: single and double push, captures */
+    pawns = pos->bb[us][PAWN] & movable;
+    to_bb = bb_shift(pawns, shift) & empty;
+    if (to_bb & target)
+        return true;
+    if (bb_shift(to_bb & bb_rel_rank(RANK_3, us), shift) & empty & target)
+        return true;
+    if (bb_pawns_attacks(pawns, shift) & enemy_pieces & target)
+        return true;
+
+    /* king */
+    to_bb = bb_king[king] & ~my_pieces;
+    while (to_bb)
+        if (!king_to_is_attacked(pos, bb_next(&to_bb), us))
+            return true;
+
+    /* sliding pieces */
+    from_bb = (pos->bb[us][BISHOP] | pos->bb[us][QUEEN]) & movable;
+    while (from_bb)
+        if (hq_bishop_moves(occ, bb_next(&from_bb)) & target)
+            return true;
+    from_bb = (pos->bb[us][ROOK] | pos->bb[us][QUEEN]) & movable;
+    while (from_bb)
+        if (hq_rook_moves(occ, bb_next(&from_bb)) & target)
+            return true;
+
+    /* pinned pieces: cannot move when in check, else stay on pin line.
+     * A pinned knight cannot move, a pinned pawn can push on king file
+     * only (a double push implies a single one).
+     */
+    if (!checkers) {
+        if (bb_shift(pinned & pos->bb[us][PAWN] & bb_sqfile[king], shift) & empty)
+            return true;
+        from_bb = pinned & ~pos->bb[us][KNIGHT];
+        while (from_bb) {
+            from = bb_next(&from_bb);
+            bitboard_t line = bb_line(from, king) & target;
+            switch (PIECE(pos->board[from])) {
+                case PAWN:
+                    to_bb = bb_pawn_attacks[us][from] & enemy_pieces;
+                    break;
+                case BISHOP:
+                    to_bb = hq_bishop_moves(occ, from);
+                    break;
+                case ROOK:
+                    to_bb = hq_rook_moves(occ, from);
+                    break;
+                default:                          /* queen */
+                    to_bb = hq_queen_moves(occ, from);
+            }
+            if (to_bb & line)
+                return true;
+        }
+    }
+
+    /* en-passant (never legal in double check) */
+    if ((to = pos->en_passant) != SQUARE_NONE && !bb_multiple(checkers)) {
+        from_bb = bb_pawn_attacks[them][to] & pos->bb[us][PAWN];
+        while (from_bb)
+            if (is_legal(pos, move_make_enpassant(bb_next(&from_bb), to), us))
+                return true;
+    }
+    return false;
+}
+
+/**
+ * gen_quiet_checks() - generate position pseudo-legal quiet checks.
+ * @pos: position
+ * @moves: &move_t array to store pseudo-moves
+ * @us: player-to-move color
+ *
+ * Generate @pos pseudo-legal non-capture moves giving check, for
+ * player-to-move, when king is not in check. Castling and promotions are
+ * not generated.
+ * Checking moves are:
+ *  - direct checks: moves to check squares of moved piece type.
+ *  - discovered checks: discovery candidates moves out of the line between
+ *    our slider and opponent king.
+ *
+ * Position check info must be set (see pos_set_check_info()).
+ *
+ * @Return: New @moves.
+ */
+static __always_inline move_t *gen_quiet_checks(pos_t *pos, move_t *moves,
+                                                const color_t us)
+{
+    square_t king            = pos->king[us];
+    square_t oking           = pos->king[OPPONENT(us)];
+    bitboard_t empty         = ~pos_occ(pos);
+    bitboard_t occ           = ~empty;
+    bitboard_t discovery     = pos->discovery;
+    bitboard_t from_bb, to_bb, tmp_bb;
+    square_t from;
+
+    bug_on(pos->checkers);
+
+    /* king: discovered checks only */
+    if (BIT(king) & discovery) {
+        to_bb = bb_king[king] & empty & ~bb_line(king, oking);
+        moves = moves_gen(moves, king, to_bb);
+    }
+
+    /* pieces: direct checks, and discovered checks out of line */
+    for (piece_type_t pt = KNIGHT; pt <= QUEEN; ++pt) {
+        bitboard_t check_squares = pos->check_squares[pt] & empty;
+
+        from_bb = pos->bb[us][pt];
+        while (from_bb) {
+            from = bb_next(&from_bb);
+            switch (pt) {
+                case KNIGHT:
+                    to_bb = bb_knight[from];
+                    break;
+                case BISHOP:
+                    to_bb = hq_bishop_moves(occ, from);
+                    break;
+                case ROOK:
+                    to_bb = hq_rook_moves(occ, from);
+                    break;
+                default:
+                    to_bb = hq_queen_moves(occ, from);
+            }
+            if (BIT(from) & discovery)
+                to_bb &= check_squares | (empty & ~bb_line(from, oking));
+            else
+                to_bb &= check_squares;
+            moves = moves_gen(moves, from, to_bb);
+        }
+    }
+
+    /* pawn: push to check squares, or discovered checks. Pawns on opponent
+     * king file cannot discover a check.
+     */
+    bitboard_t pawns     = pos->bb[us][PAWN];
+    bitboard_t disc      = pawns & discovery & ~bb_sqfile[oking];
+    bitboard_t rel_rank8 = bb_rel_rank(RANK_8, us);
+    bitboard_t rel_rank3 = bb_rel_rank(RANK_3, us);
+    int shift = sq_up(us);
+
+    tmp_bb = bb_shift(pawns, shift) & empty & ~rel_rank8;
+    to_bb = tmp_bb & (pos->check_squares[PAWN] | bb_shift(disc, shift));
+    moves = moves_gen_shift(moves, to_bb, shift);
+    to_bb = bb_shift(tmp_bb & rel_rank3, shift) & empty &
+        (pos->check_squares[PAWN] | bb_shift(disc, shift + shift));
+    return moves_gen_shift(moves, to_bb, shift + shift);
+}
+
+/**
+ * gen_pseudo() - generate position pseudo-legal moves of a given type
+ * @pos: position
+ * @moves: &move_t array to store pseudo-moves
+ * @type: generation type
+ * @us: player-to-move color
+ *
+ * Generate @pos pseudo moves of type @type for player-to-move, at address
+ * @moves. @type is:
+ *  - GEN_CAPTURES: captures (incl. en-passant) and queen promotions.
+ *  - GEN_QUIETS:   non captures (incl. castling) and under-promotions.
+ *  - GEN_ALL:      all moves.
+ * GEN_CAPTURES + GEN_QUIETS moves are exactly GEN_ALL moves.
+ *
+ * When king is in check, destination squares are always limited to the
+ * check evasion ones, whatever @type is (see pseudo_is_legal()).
+ *
+ * This function is always inlined with constant @type and @us, so that unused
+ * parts are removed, and color-relative values are constants.
+ *
+ * @Return: New @moves.
+ */
+static __always_inline move_t *gen_pseudo(pos_t *pos, move_t *moves,
+                                          const gen_type_t type, const color_t us)
 {
-    color_t us               = pos->turn;
     color_t them             = OPPONENT(us);
 
     bitboard_t my_pieces     = pos->bb[us][ALL_PIECES];
@@ -345,28 +1019,41 @@ movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
     bitboard_t dest_squares  = ~my_pieces;
     bitboard_t occ           = my_pieces | enemy_pieces;
     bitboard_t empty         = ~occ;
-    move_t *moves            = movelist->move;
+    bitboard_t target;
     square_t king = pos->king[us];
 
     bitboard_t from_bb, to_bb;
     bitboard_t tmp_bb;
     square_t from, to;
 
+    /* pieces destination squares */
+    switch (type) {
+        case GEN_CAPTURES:
+            target = enemy_pieces;
+            break;
+        case GEN_QUIETS:
+            target = empty;
+            break;
+        default:
+            target = dest_squares;
+    }
+
     /* king - MUST BE FIRST */
-    to_bb = bb_king_moves(dest_squares, king);
+    to_bb = bb_king_moves(target, king);
     moves = moves_gen(moves, king, to_bb);
 
     if (bb_multiple(pos->checkers))               /* double check, we stop here */
-        goto finish;
+        return moves;
 
     if (pos->checkers) {
         /* one checker: we limit destination squares to line between
          * checker and king + checker square (think: knight).
          */
         square_t checker = ctz64(pos->checkers);
-        dest_squares &= bb_between[king][checker] | pos->checkers;
+        dest_squares &= bb_between(king, checker) | pos->checkers;
         enemy_pieces &= dest_squares;
-    } else {
+        target &= dest_squares;
+    } else if (type != GEN_CAPTURES) {
         /* no checker: castling moves
          * Attention ! Castling flags are assumed correct
          */
@@ -394,13 +1081,13 @@ movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
     from_bb = pos->bb[us][BISHOP] | pos->bb[us][QUEEN];
     while (from_bb) {
         from = bb_next(&from_bb);
-        to_bb = hq_bishop_moves(occ, from) & dest_squares;
+        to_bb = hq_bishop_moves(occ, from) & target;
         moves = moves_gen(moves, from, to_bb);
     }
     from_bb = pos->bb[us][ROOK] | pos->bb[us][QUEEN];
     while (from_bb) {
         from = bb_next(&from_bb);
-        to_bb = hq_rook_moves(occ, from) & dest_squares;
+        to_bb = hq_rook_moves(occ, from) & target;
         moves = moves_gen(moves, from, to_bb);
     }
 
@@ -408,7 +1095,7 @@ movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
     from_bb = pos->bb[us][KNIGHT];
     while (from_bb) {
         from = bb_next(&from_bb);
-        to_bb = bb_knight_moves(dest_squares, from);
+        to_bb = bb_knight_moves(target, from);
         moves = moves_gen(moves, from, to_bb);
     }
 
@@ -420,36 +1107,32 @@ movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
     int shift = sq_up(us);
     tmp_bb = bb_shift(pos->bb[us][PAWN], shift) & empty;
 
-    to_bb = tmp_bb & ~rel_rank8 & dest_squares;   /* non promotion */
-    while(to_bb) {
-        to = bb_next(&to_bb);
-        from = to - shift;
-        *moves++ = move_make(from, to);
+    if (type != GEN_CAPTURES) {
+        to_bb = tmp_bb & ~rel_rank8 & dest_squares;   /* non promotion */
+        moves = moves_gen_shift(moves, to_bb, shift);
+
+        /* possible second push */
+        to_bb = bb_shift(tmp_bb & rel_rank3, shift) & empty & dest_squares;
+        moves = moves_gen_shift(moves, to_bb, shift + shift);
     }
     to_bb = tmp_bb & rel_rank8 & dest_squares;    /* promotions */
     while(to_bb) {
         to = bb_next(&to_bb);
         from = to - shift;
-        moves = move_gen_promotions(moves, from, to);
-    }
-
-    /* possible second push */
-    to_bb = bb_shift(tmp_bb & rel_rank3, shift) & empty & dest_squares;
-    while(to_bb) {
-        to = bb_next(&to_bb);
-        from = to - shift - shift;
-        *moves++ = move_make(from, to);
+        moves = move_gen_promotions(moves, from, to, type);
     }
 
     /* pawn: captures */
     tmp_bb = bb_pawns_attacks(pos->bb[us][PAWN], shift) & enemy_pieces;
-    to_bb = tmp_bb & ~rel_rank8;
-    while (to_bb) {
-        to = bb_next(&to_bb);
-        from_bb = bb_pawn_attacks[them][to] & pos->bb[us][PAWN];
-        while (from_bb) {
-            from = bb_next(&from_bb);
-            *moves++ = move_make(from, to);
+    if (type != GEN_QUIETS) {
+        to_bb = tmp_bb & ~rel_rank8;
+        while (to_bb) {
+            to = bb_next(&to_bb);
+            from_bb = bb_pawn_attacks[them][to] & pos->bb[us][PAWN];
+            while (from_bb) {
+                from = bb_next(&from_bb);
+                *moves++ = move_make(from, to);
+            }
         }
     }
     to_bb = tmp_bb & rel_rank8;
@@ -458,14 +1141,14 @@ movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
         from_bb = bb_pawn_attacks[them][to] & pos->bb[us][PAWN];
         while (from_bb) {
             from = bb_next(&from_bb);
-            moves = move_gen_promotions(moves, from, to);
+            moves = move_gen_promotions(moves, from, to, type);
         }
     }
 
     /* pawn: en-passant
      * TODO: special case when in-check here ?
      */
-    if ((to = pos->en_passant) != SQUARE_NONE) {
+    if (type != GEN_QUIETS && (to = pos->en_passant) != SQUARE_NONE) {
         from_bb = bb_pawn_attacks[them][to] & pos->bb[us][PAWN];
         while (from_bb) {
             from = bb_next(&from_bb);
@@ -475,10 +1158,92 @@ movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
 
     /* TODO: add function per piece, and type, for easier debug
      */
-finish:
+    return moves;
+}
+
+/**
+ * pos_gen() - generate position pseudo-legal moves of a given type
+ * @pos: position
+ * @movelist: &movelist_t array to store pseudo-moves
+ * @type: generation type (GEN_CAPTURES, GEN_QUIETS, GEN_EVASIONS,
+ *        GEN_QUIET_CHECKS, GEN_ALL)
+ *
+ * Generate @pos pseudo moves of type @type for player-to-move. See
+ * gen_pseudo() for details.
+ * GEN_EVASIONS moves are legal ones, see gen_evasions().
+ * GEN_QUIET_CHECKS needs position check info, see gen_quiet_checks().
+ * @movelist is filled with the moves.
+ *
+ * Position checkers, pinners and blockers must be set before calling this
+ * function.
+ *
+ * @Return: movelist
+ */
+movelist_t *pos_gen(pos_t *pos, movelist_t *movelist, const gen_type_t type)
+{
+    move_t *moves = movelist->move;
+
+#define gen_color(us) do {                                              \
+        switch (type) {                                                 \
+            case GEN_CAPTURES:                                          \
+                moves = gen_pseudo(pos, moves, GEN_CAPTURES, us);       \
+                break;                                                  \
+            case GEN_QUIETS:                                            \
+                moves = gen_pseudo(pos, moves, GEN_QUIETS, us);         \
+                break;                                                  \
+            case GEN_EVASIONS:                                          \
+                moves = gen_evasions(pos, moves, us);                   \
+                break;                                                  \
+            case GEN_QUIET_CHECKS:                                      \
+                moves = gen_quiet_checks(pos, moves, us);               \
+                break;                                                  \
+            case GEN_ALL:                                               \
+                moves = gen_pseudo(pos, moves, GEN_ALL, us);            \
+                break;                                                  \
+        }                                                               \
+    } while (0)
+
+    if (pos->turn == WHITE)
+        gen_color(WHITE);
+    else
+        gen_color(BLACK);
+#undef gen_color
+    movelist->nmoves = moves - movelist->move;
+    return movelist;
+}
+
+/**
+ * pos_gen_pseudo() - generate position pseudo-legal moves
+ * @pos: position
+ * @movelist: &movelist_t array to store pseudo-moves
+ *
+ * Generate all @pos pseudo moves for player-to-move.
+ * @movelist is filled with the moves.
+ *
+ * Only a few validity checks are done here (i.e. moves are not generated):
+ *  - castling, if king is in check
+ *  - castling, if king passes an enemy-controlled square (not final square).
+ * When immediately known, a few move flags are also applied in these cases:
+ *  - castling: M_CASTLE_{K,Q}
+ *  - capture (excl. en-passant): M_CAPTURE
+ *  - en-passant: M_EN_PASSANT
+ *  - promotion: M_PROMOTION
+ *  - promotion and capture
+ *
+ * This function is equivalent to pos_gen(@pos, @movelist, GEN_ALL).
+ *
+ * @Return: movelist
+ */
+movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist)
+{
+    move_t *moves = movelist->move;
+
+    if (pos->turn == WHITE)
+        moves = gen_pseudo(pos, moves, GEN_ALL, WHITE);
+    else
+        moves = gen_pseudo(pos, moves, GEN_ALL, BLACK);
     movelist->nmoves = moves - movelist->move;
     return movelist;
-    //return movelist->nmoves = moves - movelist->move;
 }
 
 /**
@@ -488,10 +1253,66 @@ finish:
  *
  * Generate all @pos legal moves for player-to-move.
  * @movelist is filled with the moves.
+ * Moves are legal by construction (see gen_evasions() and gen_legal()), no
+ * pseudo_is_legal() filter is needed.
+ *
+ * Position checkers, pinners and blockers must be set before calling this
+ * function.
  *
  * @Return: movelist
  */
 movelist_t *pos_gen_legal(pos_t *pos, movelist_t *movelist)
 {
-    return pos_legal(pos, pos_gen_pseudo(pos, movelist));
+    move_t *moves = movelist->move;
+
+    if (pos->turn == WHITE)
+        moves = pos->checkers? gen_evasions(pos, moves, WHITE): gen_legal(pos, moves, WHITE);
+    else
+        moves = pos->checkers? gen_evasions(pos, moves, BLACK): gen_legal(pos, moves, BLACK);
+    movelist->nmoves = moves - movelist->move;
+    return movelist;
+}
+
+/**
+ * movestack_gen_legal() - generate position legal moves on moves stack
+ * @pos: position
+ *
+ * Same as pos_gen_legal(), but moves are pushed on current thread moves
+ * stack (see movestack_t). Moves are between returned address and
+ * movestack_top(). Caller must movestack_pop() them when done.
+ *
+ * Position checkers, pinners and blockers must be set before calling this
+ * function.
+ *
+ * @Return: address of first generated move.
+ */
+move_t *movestack_gen_legal(pos_t *pos)
+{
+    move_t *first = movestack_top(), *moves;
+
+    bug_on(movestack.top + MOVES_MAX > MOVESTACK_SIZE);
+    if (pos->turn == WHITE)
+        moves = pos->checkers? gen_evasions(pos, first, WHITE): gen_legal(pos, first, WHITE);
+    else
+        moves = pos->checkers? gen_evasions(pos, first, BLACK): gen_legal(pos, first, BLACK);
+    movestack.top = moves - movestack.move;
+    return first;
+}
+
+/**
+ * pos_has_legal_move() - check if player-to-move has any legal move.
+ * @pos: position
+ *
+ * Cheaper than pos_gen_legal() when only terminal detection (mate or
+ * stalemate) is needed: No move is stored, and we stop on first legal
+ * move found. See has_legal_move().
+ *
+ * Position checkers, pinners and blockers must be set before calling this
+ * function.
+ *
+ * @Return: true if at least one legal move exists, false otherwise.
+ */
+bool pos_has_legal_move(const pos_t *pos)
+{
+    return pos->turn == WHITE? has_legal_move(pos, WHITE): has_legal_move(pos, BLACK);
 }
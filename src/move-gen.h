@@ -21,12 +21,33 @@
 #include "piece.h"
 #include "move.h"
 
+/**
+ * gen_type_t - move generation type.
+ * @GEN_CAPTURES: captures (incl. en-passant) and queen promotions
+ * @GEN_QUIETS:   non-captures (incl. castling) and under-promotions
+ * @GEN_EVASIONS: legal check evasions (king must be in check)
+ * @GEN_QUIET_CHECKS: non-captures giving check (king must not be in check)
+ * @GEN_ALL:      all moves
+ */
+typedef enum {
+    GEN_CAPTURES,
+    GEN_QUIETS,
+    GEN_EVASIONS,
+    GEN_QUIET_CHECKS,
+    GEN_ALL,
+} gen_type_t;
+
 bool pseudo_is_legal(const pos_t *pos, const move_t move);
+bool move_is_pseudo_legal(const pos_t *pos, const move_t move);
+bool move_gives_check(const pos_t *pos, const move_t move);
 move_t pos_next_legal(const pos_t *pos, movelist_t *movelist, int *start);
 movelist_t *pos_legal_dup(const pos_t *pos, movelist_t *pseudo, movelist_t *legal);
 movelist_t *pos_legal(const pos_t *pos, movelist_t *list);
 
+movelist_t *pos_gen(pos_t *pos, movelist_t *movelist, const gen_type_t type);
 movelist_t *pos_gen_pseudo(pos_t *pos, movelist_t *movelist);
 movelist_t *pos_gen_legal(pos_t *pos, movelist_t *movelist);
+move_t *movestack_gen_legal(pos_t *pos);
+bool pos_has_legal_move(const pos_t *pos);
 
 #endif  /* MOVEGEN_H */
@@ -19,6 +19,7 @@
 #include "move.h"
 #include "position.h"
 
+_Thread_local movestack_t movestack;              /* see movestack_top() */
 
 /*
  * /\**
@@ -195,8 +196,12 @@ void moves_print(movelist_t *moves, __unused int flags)
 {
     char str[16];
     //printf("%2d:", moves->nmoves);
-    for (int m = 0; m < moves->nmoves; ++m)
-        printf("%s ", move_to_str(str, moves->move[m], flags));
+    for (int m = 0; m < moves->nmoves; ++m) {
+        printf("%s", move_to_str(str, moves->move[m], flags));
+        if (flags & M_PR_EVAL)
+            printf("(%d)", moves->score[m]);
+        printf(" ");
+    }
     printf("\n");
 }
 
@@ -232,3 +237,143 @@ void move_sort_by_sq(movelist_t *moves)
 {
     qsort(moves->move, moves->nmoves, sizeof(move_t), _moves_cmp_bysquare);
 }
+
+/**
+ * mvv_lva() - MVV-LVA move score
+ * @move:     move_t move
+ * @piece:    moving piece
+ * @captured: piece on @move destination square
+ *
+ * See move_score_mvv_lva().
+ *
+ * @return: @move score, from 0 to 69.
+ */
+static __always_inline s16 mvv_lva(const move_t move, const piece_t piece,
+                                   const piece_t captured)
+{
+    piece_type_t victim = PIECE(captured);
+    s16 score = 0;
+
+    if (is_enpassant(move))
+        victim = PAWN;
+    if (victim)
+        score = victim * PT_NB - PIECE(piece);
+    if (is_promotion(move))
+        score += move_promoted(move) * PT_NB;
+    return score;
+}
+
+/**
+ * move_score_mvv_lva() - score moves list with MVV-LVA
+ * @pos: &position
+ * @moves: &movelist_t
+ *
+ * Set moves ordering score with "Most Valuable Victim - Least Valuable
+ * Attacker": Captures are ordered by captured piece type (descending), then
+ * by moving piece type (ascending). Promotions are scored as the capture of
+ * the promoted piece type (added to the capture score, if any).
+ * Non-capture, non-promotion moves score is zero, all others are positive.
+ */
+void move_score_mvv_lva(const pos_t *pos, movelist_t *moves)
+{
+    for (int m = 0; m < moves->nmoves; ++m) {
+        move_t move = moves->move[m];
+
+        moves->score[m] = mvv_lva(move, pos->board[move_from(move)],
+                                  pos->board[move_to(move)]);
+    }
+}
+
+/**
+ * moves_extend() - build extended moves list.
+ * @pos:    &position
+ * @moves:  &movelist_t generated moves
+ * @emoves: &emovelist_t extended moves list to fill
+ *
+ * Fill @emoves with @moves, adding moving piece, captured piece and
+ * MVV-LVA score (see move_score_mvv_lva()). This is the only place where
+ * the mailbox is read: Later move_do_ext() and emove_pick_best() use the
+ * extended move data.
+ * Moves generators store compact 16 bits moves (with vector
+ * serialization), this is why this pass is separate.
+ *
+ * @return: @emoves.
+ */
+emovelist_t *moves_extend(const pos_t *pos, const movelist_t *moves, emovelist_t *emoves)
+{
+    for (int m = 0; m < moves->nmoves; ++m) {
+        move_t move = moves->move[m];
+        piece_t piece = pos->board[move_from(move)];
+        piece_t captured = pos->board[move_to(move)];
+
+        emoves->move[m] = emove_make(move, piece, captured,
+                                     mvv_lva(move, piece, captured));
+    }
+    emoves->nmoves = moves->nmoves;
+    return emoves;
+}
+
+/**
+ * move_pick_best() - get next best move in moves list.
+ * @moves: &movelist_t scored moves list
+ * @cur:   &int, current position in @moves
+ *
+ * Find the highest score move in @moves, from position @cur, and swap it
+ * (with its score) with @cur one. @cur is then incremented.
+ * This is an incremental selection sort: Moves list is not fully sorted, as
+ * most of the time we do not need to go beyond the first moves.
+ *
+ * @return: best remaining move, or MOVE_NONE if no more moves.
+ */
+move_t move_pick_best(movelist_t *moves, int *cur)
+{
+    int best = *cur;
+    move_t move;
+    s16 score;
+
+    if (best >= moves->nmoves)
+        return MOVE_NONE;
+
+    for (int m = best + 1; m < moves->nmoves; ++m)
+        if (moves->score[m] > moves->score[best])
+            best = m;
+
+    move = moves->move[best];
+    score = moves->score[best];
+    moves->move[best] = moves->move[*cur];
+    moves->score[best] = moves->score[*cur];
+    moves->move[*cur] = move;
+    moves->score[*cur] = score;
+    (*cur)++;
+    return move;
+}
+
+/**
+ * emove_pick_best() - get next best move in extended moves list.
+ * @emoves: &emovelist_t extended moves list
+ * @cur:    &int, current position in @emoves
+ *
+ * Same as move_pick_best(), for extended moves. As score uses the highest
+ * bits of emove_t, whole moves are compared: For equal scores, order may
+ * differ from move_pick_best() one.
+ *
+ * @return: best remaining move, or MOVE_NONE if no more moves.
+ */
+emove_t emove_pick_best(emovelist_t *emoves, int *cur)
+{
+    int best = *cur;
+    emove_t emove;
+
+    if (best >= emoves->nmoves)
+        return MOVE_NONE;
+
+    for (int m = best + 1; m < emoves->nmoves; ++m)
+        if (emoves->move[m] > emoves->move[best])
+            best = m;
+
+    emove = emoves->move[best];
+    emoves->move[best] = emoves->move[*cur];
+    emoves->move[*cur] = emove;
+    (*cur)++;
+    return emove;
+}
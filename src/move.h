@@ -42,6 +42,7 @@ typedef enum {
     M_PROMOTED_MASK = 0030000,
     M_FLAGS_MASK    = 0140000,
 
+    M_NORMAL        =       0,                       /* 0 << M_OFF_FLAGS */
     M_ENPASSANT     =  040000,                       /* 1 << M_OFF_FLAGS */
     M_CASTLE        = 0100000,                       /* 2 << M_OFF_FLAGS */
     M_PROMOTION     = 0140000,                       /* 3 << M_OFF_FLAGS */
@@ -63,9 +64,68 @@ typedef enum {
 
 typedef struct __movelist_s {
     move_t move[MOVES_MAX];
+    s16 score[MOVES_MAX];                         /* move ordering score */
     int nmoves;                                   /* total moves (fill) */
 } movelist_t;
 
+/* per-thread moves stack: Each ply appends its generated moves at stack
+ * top, and pops them on return (see movestack_gen_legal()). Moves storage
+ * stays dense, instead of one (mostly unused) movelist_t per ply.
+ */
+#define MOVESTACK_SIZE  (MOVES_MAX * 64)
+
+typedef struct __movestack_s {
+    int top;                                      /* first free slot */
+    move_t move[MOVESTACK_SIZE];
+} movestack_t;
+
+extern _Thread_local movestack_t movestack;
+
+/**
+ * movestack_top() - get current thread moves stack top.
+ *
+ * @return: address of first free move_t in stack.
+ */
+static inline move_t *movestack_top(void)
+{
+    return movestack.move + movestack.top;
+}
+
+/**
+ * movestack_pop() - pop moves from current thread moves stack.
+ * @first: first move_t to pop (and new stack top)
+ */
+static inline void movestack_pop(move_t *first)
+{
+    movestack.top = first - movestack.move;
+}
+
+/* extended move structure, see moves_extend():
+ *
+ * bits    len off range         type      mask          get  desc
+ * ...       16   0  0-15         move_t      0177777       &0177777 move
+ * pppp       4  16 16-19        piece_t      017 << 16 (>>16) &017 moving piece
+ * cccc       4  20 20-23        piece_t      017 << 20 (>>20) &017 captured piece
+ * ssssssss   8  24 24-31            u8     0377 << 24 (>>24)       ordering score
+ *
+ * Captured piece is the piece on "to" square (EMPTY for en-passant).
+ * As score uses highest bits, comparing two extended moves compares their
+ * scores first.
+ * Transposition table keeps the compact move_t.
+ */
+typedef u32 emove_t;
+
+enum {
+    EM_OFF_PIECE    = 16,
+    EM_OFF_CAPTURED = 20,
+    EM_OFF_SCORE    = 24
+};
+
+typedef struct __emovelist_s {
+    emove_t move[MOVES_MAX];
+    int nmoves;                                   /* total moves (fill) */
+} emovelist_t;
+
 static inline square_t move_from(move_t move)
 {
     return move & 077;
@@ -93,6 +153,32 @@ static inline piece_type_t move_promoted(move_t move)
  * }
  */
 
+static inline move_t emove_move(emove_t emove)
+{
+    return (move_t) emove;
+}
+
+static inline piece_t emove_piece(emove_t emove)
+{
+    return (emove >> EM_OFF_PIECE) & 017;
+}
+
+static inline piece_t emove_captured(emove_t emove)
+{
+    return (emove >> EM_OFF_CAPTURED) & 017;
+}
+
+static inline u8 emove_score(emove_t emove)
+{
+    return emove >> EM_OFF_SCORE;
+}
+
+static inline emove_t emove_make(move_t move, piece_t piece, piece_t captured, u8 score)
+{
+    return (emove_t) score << EM_OFF_SCORE | captured << EM_OFF_CAPTURED |
+        piece << EM_OFF_PIECE | move;
+}
+
 static inline move_t move_make(square_t from, square_t to)
 {
     return (to << M_OFF_TO) | from;
@@ -153,5 +239,9 @@ move_t move_from_str(const char *str);
 move_t move_find_in_movelist(move_t target, movelist_t *list);
 void moves_print(movelist_t *moves, int flags);
 void move_sort_by_sq(movelist_t *moves);
+void move_score_mvv_lva(const pos_t *pos, movelist_t *moves);
+move_t move_pick_best(movelist_t *moves, int *cur);
+emovelist_t *moves_extend(const pos_t *pos, const movelist_t *moves, emovelist_t *emoves);
+emove_t emove_pick_best(emovelist_t *emoves, int *cur);
 
 #endif  /* MOVE_H */
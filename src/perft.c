@@ -12,12 +12,69 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <stdalign.h>
 
 #include <brlib.h>
 
 #include "perft.h"
 #include "move-gen.h"
 #include "move-do.h"
+#include "alloc.h"
+
+#ifdef COPY_MAKE
+/**
+ * perft_copy() - perft, copy-make version.
+ * @pos:    &position to search, in a per-ply positions stack
+ * @depth:  Wanted depth.
+ * @ply:    current perft depth level (root = 1)
+ * @divide: output total for 1st level moves.
+ *
+ * Same as perft() make/unmake version, but each move is done with
+ * move_do_copy() into next stack slot (@pos + 1): There is no move undo.
+ *
+ * @return: total moves found at @depth level.
+ */
+static u64 perft_copy(pos_t *pos, int depth, int ply, bool divide)
+{
+    u64 subnodes = 0, nodes = 0;
+    move_t *first, *move, *last;
+    pos_t *next = pos + 1;
+
+    first = movestack_gen_legal(pos);
+    last = movestack_top();
+    for (move = first; move < last; ++move) {
+        if (depth == 1) {
+            subnodes = 1;
+        } else {
+            move_do_copy(pos, *move, next);
+            if (depth == 2) {
+                move_t *first2 = movestack_gen_legal(next);
+                subnodes = movestack_top() - first2;
+                movestack_pop(first2);
+            } else if (ply >= 3) {
+                hentry_t *entry = tt_probe_perft(next->key, depth);
+                if (entry != TT_MISS) {
+                    subnodes = HASH_PERFT_VAL(entry->data);
+                } else {
+                    subnodes = perft_copy(next, depth - 1, ply + 1, divide);
+                    tt_store_perft(next->key, depth, subnodes);
+                }
+            } else {
+                subnodes = perft_copy(next, depth - 1, ply + 1, divide);
+            }
+        }
+        nodes += subnodes;
+        if (ply == 1 && divide) {
+            char movestr[8];
+            printf("%s: %lu\n", move_to_str(movestr, *move, 0), subnodes);
+        }
+    }
+    movestack_pop(first);
+
+    return nodes;
+}
+#endif
 
 /**
  * perft() - Perform perft on position
@@ -28,38 +85,53 @@
  *
  * Run perft on a position. This function displays the available moves at @depth
  * level for each possible first move, and the total of moves.
+ * Moves are generated on current thread moves stack (see movestack_t).
  *
  * This version uses the algorithm:
  *    if last depth
  *      return 1;
- *    gen legal moves
+ *    gen legal moves (legal generator)
  *    loop for legal move
  *      do-move
  *      perft (depth -1)
  *      undo-move
  *
+ * If COPY_MAKE is defined, moves are done on position copies instead (see
+ * perft_copy()).
+ *
  * @return: total moves found at @depth level.
  */
 u64 perft(pos_t *pos, int depth, int ply, bool divide)
 {
     u64 subnodes = 0, nodes = 0;
-    movelist_t movelist;
-    move_t *move, *last;
+    move_t *first, *move, *last;
     state_t state;
 
-    pos_set_checkers_pinners_blockers(pos);
+    /* checkers/pinners/blockers are then maintained by move_do() */
+    if (ply == 1)
+        pos_set_checkers_pinners_blockers(pos);
+
+#ifdef COPY_MAKE
+    /* one stack slot per ply: moves are never done at last depth */
+    pos_t *stack = safe_alloc_aligned(alignof(pos_t), depth * sizeof(pos_t));
+
+    memcpy(stack, pos, POS_COPY_SIZE);
+    nodes = perft_copy(stack, depth, ply, divide);
+    safe_free(stack);
+    return nodes;
+#endif
 
-    pos_legal(pos, pos_gen_pseudo(pos, &movelist));
-    last = movelist.move + movelist.nmoves;
-    for (move = movelist.move; move < last; ++move) {
+    first = movestack_gen_legal(pos);
+    last = movestack_top();
+    for (move = first; move < last; ++move) {
         if (depth == 1) {
             subnodes = 1;
         } else {
             move_do(pos, *move, &state);
             if (depth == 2) {
-                movelist_t movelist2;
-                pos_set_checkers_pinners_blockers(pos);
-                subnodes = pos_legal(pos, pos_gen_pseudo(pos, &movelist2))->nmoves;
+                move_t *first2 = movestack_gen_legal(pos);
+                subnodes = movestack_top() - first2;
+                movestack_pop(first2);
             } else if (ply >= 3) {
                 hentry_t *entry = tt_probe_perft(pos->key, depth);
                 if (entry != TT_MISS) {
@@ -79,6 +151,7 @@ u64 perft(pos_t *pos, int depth, int ply, bool divide)
             printf("%s: %lu\n", move_to_str(movestr, *move, 0), subnodes);
         }
     }
+    movestack_pop(first);
 
     return nodes;
 }
@@ -99,18 +172,22 @@ u64 perft_alt(pos_t *pos, int depth, int ply, bool divide)
 {
     u64 subnodes = 0, nodes = 0;
     movelist_t movelist;
-    move_t *move, *last;
+    move_t move;
     state_t state;
+    int cur = 0;
 
+    /* legality is checked lazily, just before the move is played.
+     * checkers/pinners/blockers are restored by move_undo_alt(), for next
+     * pseudo_is_legal() calls.
+     */
     pos_set_checkers_pinners_blockers(pos);
 
-    pos_legal(pos, pos_gen_pseudo(pos, &movelist));
-    last = movelist.move + movelist.nmoves;
-    for (move = movelist.move; move < last; ++move) {
+    pos_gen_pseudo(pos, &movelist);
+    while ((move = pos_next_legal(pos, &movelist, &cur)) != MOVE_NONE) {
         if (depth == 1) {
             subnodes = 1;
         } else {
-            move_do_alt(pos, *move, &state);
+            move_do_alt(pos, move, &state);
             if (depth == 2) {
                 movelist_t movelist2;
                 pos_set_checkers_pinners_blockers(pos);
@@ -118,12 +195,12 @@ u64 perft_alt(pos_t *pos, int depth, int ply, bool divide)
             } else {
                 subnodes = perft_alt(pos, depth - 1, ply + 1, divide);
             }
-            move_undo_alt(pos, *move, &state);
+            move_undo_alt(pos, move, &state);
         }
         nodes += subnodes;
         if (ply == 1 && divide) {
             char movestr[8];
-            printf("%s: %lu\n", move_to_str(movestr, *move, 0), subnodes);
+            printf("%s: %lu\n", move_to_str(movestr, move, 0), subnodes);
         }
     }
 
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdalign.h>
 #include <ctype.h>
 #include <assert.h>
 
@@ -43,14 +44,14 @@
  */
 pos_t *pos_new(void)
 {
-    return safe_alloc(sizeof(pos_t));
+    return safe_alloc_aligned(alignof(pos_t), sizeof(pos_t));
 }
 
 /**
  * pos_dup() - duplicate a position.
  * @pos: &position to duplicate.
  *
- * Return a copy, allocated with malloc(1), of @pos.
+ * Return a copy, allocated with aligned_alloc(3), of @pos.
  *
  * @Return: The new position.
  *
@@ -58,7 +59,7 @@ pos_t *pos_new(void)
  */
 pos_t *pos_dup(const pos_t *pos)
 {
-    pos_t *newpos = safe_alloc(sizeof(pos_t));
+    pos_t *newpos = safe_alloc_aligned(alignof(pos_t), sizeof(pos_t));
 
     *newpos = *pos;
     return newpos;
@@ -125,12 +126,13 @@ bool pos_cmp(const pos_t *pos1, const pos_t *pos2)
 #define _cmpf(a) (pos1->a != pos2->a)
     bool ret = false;
 
-    if (_cmpf(node_count) || _cmpf(turn))
+    if (_cmpf(turn))
         goto end;
 
     /* move_do/undo position state */
     if (_cmpf(key) || _cmpf(en_passant) || _cmpf(castle) ||
-        _cmpf(clock_50) || _cmpf(plycount) || _cmpf(captured))
+        _cmpf(clock_50) || _cmpf(plycount) || _cmpf(captured) ||
+        _cmpf(psq) || _cmpf(material) || _cmpf(phase))
         goto end;
 
     if (_cmpf(checkers) || _cmpf(pinners) || _cmpf(blockers))
@@ -164,6 +166,77 @@ end:
 #undef _cmpf
 }
 
+#ifdef POS_ATTACKS
+/**
+ * piece_attacks() - get squares attacked by a piece
+ * @piece: piece (EMPTY is allowed)
+ * @sq:    piece square
+ * @occ:   occupation bitboard
+ *
+ * @return: bitboard of squares attacked by @piece on @sq.
+ */
+static bitboard_t piece_attacks(const piece_t piece, const square_t sq, const bitboard_t occ)
+{
+    switch (PIECE(piece)) {
+        case PAWN:
+            return bb_pawn_attacks[COLOR(piece)][sq];
+        case KNIGHT:
+            return bb_knight[sq];
+        case BISHOP:
+            return hq_bishop_moves(occ, sq);
+        case ROOK:
+            return hq_rook_moves(occ, sq);
+        case QUEEN:
+            return hq_queen_moves(occ, sq);
+        case KING:
+            return bb_king[sq];
+        default:
+            return 0;
+    }
+}
+
+/**
+ * pos_set_attacks() - set attacks of a square, and update attackers table
+ * @pos:     &position
+ * @sq:      square
+ * @attacks: squares now attacked from @sq
+ */
+static __always_inline void pos_set_attacks(pos_t *pos, const square_t sq,
+                                            const bitboard_t attacks)
+{
+    bitboard_t changed = pos->attacks[sq] ^ attacks;
+
+    pos->attacks[sq] = attacks;
+    while (changed)
+        pos->attackers[bb_next(&changed)] ^= BIT(sq);
+}
+
+/**
+ * pos_update_attacks() - update attack tables after a square change
+ * @pos: &position
+ * @sq:  square which was just set or cleared
+ *
+ * Recompute the attacks from @sq, and those of the sliders whose rays go
+ * through @sq. These sliders are exactly the @sq attackers, as a ray
+ * reaches a square whether this square is empty or not.
+ * Attacks from all other squares are unchanged.
+ */
+void pos_update_attacks(pos_t *pos, const square_t sq)
+{
+    bitboard_t occ = pos_occ(pos);
+    bitboard_t sliders = pos->attackers[sq] &
+        (pos->bb[WHITE][BISHOP] | pos->bb[BLACK][BISHOP] |
+         pos->bb[WHITE][ROOK] | pos->bb[BLACK][ROOK] |
+         pos->bb[WHITE][QUEEN] | pos->bb[BLACK][QUEEN]);
+
+    pos_set_attacks(pos, sq, piece_attacks(pos->board[sq], sq, occ));
+    while (sliders) {
+        square_t slider = bb_next(&sliders);
+        pos_set_attacks(pos, slider, piece_attacks(pos->board[slider], slider, occ));
+    }
+}
+#endif
+
 /**
  * pos_checkers() - find all checkers on a king.
  * @pos:   &position
@@ -176,81 +249,219 @@ end:
  */
 bitboard_t pos_checkers(const pos_t *pos, const color_t color)
 {
+#ifdef POS_ATTACKS
+    return pos->attackers[pos->king[color]] & pos->bb[OPPONENT(color)][ALL_PIECES];
+#else
     bitboard_t occ = pos_occ(pos);
     return sq_attackers(pos, occ, pos->king[color], OPPONENT(color));
+#endif
 }
 
 /**
- * pos_set_checkers_pinners_blockers() - calculate checkers, pinners and blockers.
- * @pos:   &position
+ * king_line_info() - find slider checkers, pinners and blockers on a king line
+ * @pos:       &position
+ * @king:      king square
+ * @line:      king line (bb_sqfile, bb_sqrank, bb_sqdiag or bb_sqanti)
+ * @rank:      true if @line is king rank (HQ does not work on ranks)
+ * @attackers: opponent sliders which can attack on @line
+ * @pinners:   &bitboard_t pinners to update
+ * @blockers:  &bitboard_t blockers to update
  *
- * Set position checkers, pinners and blockers on player-to-play king.
- * It should be slightly faster than @pos_checkers + @pos_set_pinners_blockers, as
- * some calculation will be done once.
+ * @return: checkers on king line.
  */
-void pos_set_checkers_pinners_blockers(pos_t *pos)
+static __always_inline bitboard_t king_line_info(const pos_t *pos, const square_t king,
+                                                 const bitboard_t line, const bool rank,
+                                                 const bitboard_t attackers,
+                                                 bitboard_t *pinners, bitboard_t *blockers)
 {
-    int us = pos->turn, them = OPPONENT(us);
     bitboard_t occ = pos_occ(pos);
-    bitboard_t attackers;
-    bitboard_t checkers = 0, blockers = 0, pinners = 0;
-    bitboard_t targets, tmpcheckers, maybeblockers, tmppinners;
-    square_t king = pos->king[us];
+    bitboard_t checkers, maybeblockers, targets;
     int pinner;
 
-    /* bishop type - we attack with a bishop from king position */
-    attackers = pos->bb[them][BISHOP] | pos->bb[them][QUEEN];
+    *pinners &= ~line;
+    *blockers &= ~line;
 
-    /* targets is all "target" pieces if K was a bishop */
-    targets = hq_bishop_moves(occ, king) & occ;
+    /* targets is all "target" pieces if K was a slider on this line */
+#define line_moves(o) (rank? hq_rank_moves(o, king): hq_moves(o, king, line))
+    targets = line_moves(occ) & occ;
 
-    /* checkers = only opponent B/Q */
-    tmpcheckers = targets & attackers;
-    checkers |= tmpcheckers;
+    /* checkers = only opponent sliders */
+    checkers = targets & attackers;
 
     /* maybe blockers = we remove checkers, to look "behind" */
-    maybeblockers = targets & ~tmpcheckers;
+    maybeblockers = targets & ~checkers;
 
     /* we find second targets, by removing first ones (excl. checkers) */
     if (maybeblockers) {
-        targets = hq_bishop_moves(occ ^ maybeblockers, king) ^ tmpcheckers;
-
-        /* pinners = only B/Q */
-        tmppinners = targets & attackers;
+        targets = line_moves(occ ^ maybeblockers) & attackers & ~checkers;
 
         /* blockers = we find occupied squares between pinner and king */
-        while (tmppinners) {
-            pinner = bb_next(&tmppinners);
-            pinners |= BIT(pinner);
-            blockers |= bb_between[pinner][king] & maybeblockers;
+        while (targets) {
+            pinner = bb_next(&targets);
+            *pinners |= BIT(pinner);
+            *blockers |= bb_between(pinner, king) & maybeblockers;
         }
     }
+    return checkers;
+#undef line_moves
+}
 
-    /* same for rook type */
-    attackers = pos->bb[them][ROOK] | pos->bb[them][QUEEN];
-    targets = hq_rook_moves(occ, king) & occ;
+/**
+ * king_lines_update() - update slider checkers, pinners and blockers on king lines
+ * @pos:      &position
+ * @color:    king color
+ * @changed:  changed squares
+ * @pinners:  &bitboard_t pinners to update
+ * @blockers: &bitboard_t blockers to update
+ *
+ * Only king lines (ranks, files, diagonals) going through @changed squares
+ * are looked up, @pinners and @blockers on other lines are kept. For a full
+ * lookup, @changed should be all squares, and @pinners and @blockers zero.
+ *
+ * @return: @color opponent sliders checking @color king on updated lines.
+ */
+static __always_inline bitboard_t king_lines_update(const pos_t *pos, const color_t color,
+                                                    const bitboard_t changed,
+                                                    bitboard_t *pinners, bitboard_t *blockers)
+{
+    color_t them = OPPONENT(color);
+    square_t king = pos->king[color];
+    bitboard_t bishops = pos->bb[them][BISHOP] | pos->bb[them][QUEEN];
+    bitboard_t rooks = pos->bb[them][ROOK] | pos->bb[them][QUEEN];
+    bitboard_t checkers = 0;
+
+    if (changed & bb_sqdiag[king])
+        checkers |= king_line_info(pos, king, bb_sqdiag[king], false, bishops,
+                                   pinners, blockers);
+    if (changed & bb_sqanti[king])
+        checkers |= king_line_info(pos, king, bb_sqanti[king], false, bishops,
+                                   pinners, blockers);
+    if (changed & bb_sqfile[king])
+        checkers |= king_line_info(pos, king, bb_sqfile[king], false, rooks,
+                                   pinners, blockers);
+    if (changed & bb_sqrank[king])
+        checkers |= king_line_info(pos, king, bb_sqrank[king], true, rooks,
+                                   pinners, blockers);
+    return checkers;
+}
 
-    tmpcheckers = targets & attackers;
-    checkers |= tmpcheckers;
+/**
+ * pos_set_checkers_pinners_blockers() - calculate checkers, pinners and blockers.
+ * @pos:   &position
+ *
+ * Set position checkers, pinners and blockers on player-to-play king, and
+ * pinners and blockers on opponent king (opp_pinners and opp_blockers).
+ * It should be slightly faster than @pos_checkers + @pos_set_pinners_blockers, as
+ * some calculation will be done once.
+ */
+void pos_set_checkers_pinners_blockers(pos_t *pos)
+{
+    int us = pos->turn, them = OPPONENT(us);
+    square_t king = pos->king[us];
+    bitboard_t checkers;
 
-    maybeblockers = targets & ~tmpcheckers;
-    if (maybeblockers) {
-        targets = hq_rook_moves(occ ^ maybeblockers, king) ^ tmpcheckers;
-        tmppinners = targets & attackers;
-        while (tmppinners) {
-            pinner = bb_next(&tmppinners);
-            pinners |= BIT(pinner);
-            blockers |= bb_between[pinner][king] & maybeblockers;
-        }
-    }
+    pos->pinners = pos->blockers = pos->opp_pinners = pos->opp_blockers = 0;
+    checkers = king_lines_update(pos, us, ~0ull, &pos->pinners, &pos->blockers);
 
     /* pawns & knights */
     checkers |= bb_pawn_attacks[us][king] & pos->bb[them][PAWN];
     checkers |= bb_knight[king] & pos->bb[them][KNIGHT];
-
     pos->checkers = checkers;
-    pos->pinners = pinners;
-    pos->blockers = blockers;
+
+    king_lines_update(pos, them, ~0ull, &pos->opp_pinners, &pos->opp_blockers);
+}
+
+/**
+ * pos_update_checkers_pinners_blockers() - update checkers, pinners and blockers.
+ * @pos:   &position
+ * @move:  move just done
+ *
+ * Incremental version of pos_set_checkers_pinners_blockers(), called by
+ * move_do() after @move is done, with previous values valid for both kings.
+ *
+ * Only king lines through @move from and to squares are looked up: Checks
+ * can only be direct from the moved piece, or discovered through from.
+ * A full lookup is done for the king which moved, and for castling and
+ * en-passant.
+ */
+void pos_update_checkers_pinners_blockers(pos_t *pos, const move_t move)
+{
+    color_t us = pos->turn, them = OPPONENT(us);  /* us is now to play */
+    square_t to = move_to(move);
+    square_t king = pos->king[us];
+    bitboard_t changed = BIT(move_from(move)) | BIT(to);
+    bitboard_t pinners = pos->opp_pinners, blockers = pos->opp_blockers;
+    bitboard_t oppinners = pos->pinners, oppblockers = pos->blockers;
+    bitboard_t checkers;
+
+    if (is_castle(move) || is_enpassant(move)) {
+        pos_set_checkers_pinners_blockers(pos);
+        return;
+    }
+
+    /* player-to-play king: it was not in check before @move */
+    checkers = king_lines_update(pos, us, changed, &pinners, &blockers);
+    checkers |= ((bb_pawn_attacks[us][king] & pos->bb[them][PAWN]) |
+                 (bb_knight[king] & pos->bb[them][KNIGHT])) & BIT(to);
+
+    /* opponent king (which just played) */
+    if (pos->king[them] == to) {
+        changed = ~0ull;
+        oppinners = oppblockers = 0;
+    }
+    king_lines_update(pos, them, changed, &oppinners, &oppblockers);
+
+    pos->checkers     = checkers;
+    pos->pinners      = pinners;
+    pos->blockers     = blockers;
+    pos->opp_pinners  = oppinners;
+    pos->opp_blockers = oppblockers;
+}
+
+/**
+ * pos_set_check_info() - set position check squares and discovery candidates.
+ * @pos:   &position
+ *
+ * Set, for player-to-play, the information needed to find checking moves
+ * on opponent king:
+ *  - check_squares[pt]: squares from which a @pt piece would attack opponent
+ *    king (0 for KING).
+ *  - discovery: our pieces which are the only blocker between one of our
+ *    sliding pieces and opponent king. Moving such a piece out of this line
+ *    gives a discovered check.
+ *
+ * This information is not maintained by move_do(), and is not needed by move
+ * generation: This function must be explicitly called before using it (see
+ * GEN_QUIET_CHECKS and move_gives_check()).
+ */
+void pos_set_check_info(pos_t *pos)
+{
+    color_t us = pos->turn, them = OPPONENT(us);
+    square_t king = pos->king[them];
+    bitboard_t occ = pos_occ(pos);
+    bitboard_t my_pieces = pos->bb[us][ALL_PIECES];
+    bitboard_t sliders, blockers, discovery = 0;
+    square_t slider;
+
+    pos->check_squares[PAWN]   = bb_pawn_attacks[them][king];
+    pos->check_squares[KNIGHT] = bb_knight[king];
+    pos->check_squares[BISHOP] = hq_bishop_moves(occ, king);
+    pos->check_squares[ROOK]   = hq_rook_moves(occ, king);
+    pos->check_squares[QUEEN]  = pos->check_squares[BISHOP] | pos->check_squares[ROOK];
+    pos->check_squares[KING]   = 0;
+
+    /* our sliders on opponent king lines, with exactly one (our) blocker */
+    sliders = ((pos->bb[us][BISHOP] | pos->bb[us][QUEEN]) &
+               (bb_sqdiag[king] | bb_sqanti[king])) |
+        ((pos->bb[us][ROOK] | pos->bb[us][QUEEN]) &
+         (bb_sqrank[king] | bb_sqfile[king]));
+    while (sliders) {
+        slider = bb_next(&sliders);
+        blockers = bb_between_excl(slider, king) & occ;
+        if (blockers && !bb_multiple(blockers))
+            discovery |= blockers & my_pieces;
+    }
+    pos->discovery = discovery;
 }
 
 /**
@@ -270,7 +481,7 @@ void pos_set_pinners_blockers(pos_t *pos)
     bit_for_each64(pinner, tmp, pos->pinners) {
         //bitboard_t blocker =
         // warn_on(popcount64(blocker) != 1);
-        blockers |= bb_between_excl[pinner][king] & occ;
+        blockers |= bb_between_excl(pinner, king) & occ;
     }
     pos->blockers = blockers;
     return;
@@ -313,7 +524,7 @@ bitboard_t pos_king_blockers(const pos_t *pos, const color_t color, const bitboa
         //    printf("n blockers = %d\n", popcount64(blocker));
         //    bb_print("blockers", blocker);
         //}
-        blockers |= bb_between_excl[pinner][king] & occ;
+        blockers |= bb_between_excl(pinner, king) & occ;
     }
     return blockers;
 }
@@ -379,6 +590,16 @@ bool pos_ok(pos_t *pos, const bool strict)
     }
     /* occupied board is different from bitboards */
     error += warn_on_or_eval(count != bbcount);
+#ifdef POS_ATTACKS
+    /* incremental attack tables are different from calculated ones */
+    for (square_t sq = 0; sq < 64; ++sq) {
+        error += warn_on_or_eval(pos->attacks[sq] !=
+                                 piece_attacks(pos->board[sq], sq, pos_occ(pos)));
+        error += warn_on_or_eval(pos->attackers[sq] !=
+                                 (sq_attackers(pos, pos_occ(pos), sq, WHITE) |
+                                  sq_attackers(pos, pos_occ(pos), sq, BLACK)));
+    }
+#endif
     /* is opponent already in check ? */
     error += warn_on_or_eval(pos_checkers(pos, them));
     /* is color to play in check more than twice ? */
@@ -14,6 +14,8 @@
 #ifndef POSITION_H
 #define POSITION_H
 
+#include <stddef.h>
+#include <assert.h>
 #include <stdint.h>
 
 #include <brlib.h>
@@ -29,47 +31,95 @@
 #include "board.h"
 
 typedef struct __pos_s {
-    u64 node_count;                               /* evaluated nodes */
-    int turn;                                     /* WHITE or BLACK */
+    /* First part, up to (excluded) "eval", is the data needed to play a
+     * move: it is the only part copied by move_do_copy(). Keep it compact
+     * and first in structure.
+     * Layout (64 bytes cache lines, see static asserts below):
+     *   line 0-1: bitboards, state small fields
+     *   line 2:   state key, checkers, pinners, blockers, ...
+     *   line 3:   board
+     */
+    bitboard_t bb[2][PT_NB];                      /* bb[0][PAWN], bb[1][ALL_PIECES] */
 
-    /* data which cannot be recovered by move_undo (like castle_rights, ...).
-     *
-     * Attention: checkers/pinners/blockers are not included here, and
-     * are not available in move_undo or any following legality check.
+    /* data which cannot be recovered by move_undo (like castle_rights, ...),
+     * or which is cheaper to restore than to recover (turn, kings).
      *
      * Following data can be accessed either directly, either via "state"
      * structure name.
      * For example, pos->en_passant and pos->state.en_passant are the same.
      * This allows a memcpy on this data (to save/restore position state).
+     *
+     * checkers/pinners/blockers are updated by move_do() (and restored by
+     * move_undo()) for both kings, to allow incremental update.
      */
     struct_group_tagged(state_s, state,
 
-                        /* 64 bits */
-                        struct state_s *prev;
-                        hkey_t key;
+                        /* 32 bits */
+                        int turn;                 /* WHITE or BLACK */
+                        score_t psq;              /* material+PST, white - black */
+                        u32 material;             /* material key, see zobrist_material_calc() */
 
                         /* 16 bits */
                         move_t move;
                         u16 plycount;             /* plies so far, start from 1 */
-                        s16 phase;
+
+                        /* 64 bits */
+                        hkey_t key;
+                        bitboard_t checkers;      /* opponent checkers */
+                        bitboard_t pinners;       /* opponent pinners */
+                        bitboard_t blockers;      /* pieces blocking pin */
+                        bitboard_t opp_pinners;   /* pinners on opponent king */
+                        bitboard_t opp_blockers;  /* pieces blocking pin on opp. king */
+                        struct state_s *prev;
+
+                        /* 16 bits */
+                        s16 phase;                /* not clamped, see calc_phase() */
 
                         /* 8 bits */
+                        square_t king[2];         /* dup with bb, faster retrieval */
                         square_t en_passant;
                         castle_rights_t castle;
                         piece_t captured;         /* only used in move_undo */
                         u8 clock_50;
         );
-    eval_t eval;
-    bitboard_t checkers;                          /* opponent checkers */
-    bitboard_t pinners;                           /* opponent pinners */
-    bitboard_t blockers;                          /* pieces blocking pin */
     piece_t board[BOARDSIZE];
-    bitboard_t bb[2][PT_NB];                      /* bb[0][PAWN], bb[1][ALL_PIECES] */
-    square_t king[2];                             /* dup with bb, faster retrieval */
-} pos_t;
+#ifdef POS_ATTACKS
+    /* incremental attack tables, updated by pos_set_sq() and pos_clr_sq() */
+    bitboard_t attacks[BOARDSIZE];                /* squares attacked by piece on sq */
+    bitboard_t attackers[BOARDSIZE];              /* pieces (both colors) attacking sq */
+#endif
+
+    /* not copied by move_do_copy() */
+    eval_t eval;
+    /* check info, set by pos_set_check_info() */
+    bitboard_t check_squares[PT_NB];              /* squares giving direct check */
+    bitboard_t discovery;                         /* discovered check candidates */
+} __attribute__((aligned(64))) pos_t;
+
+/* size of pos_t part copied by move_do_copy() */
+#define POS_COPY_SIZE  offsetof(pos_t, eval)
+
+static_assert(offsetof(pos_t, bb) + sizeof(((pos_t *)0)->bb) <= 2 * 64,
+              "pos_t: bitboards must fit in 2 cache lines");
+static_assert(offsetof(pos_t, key) == 2 * 64,
+              "pos_t: key/checkers/pinners/blockers must start 3rd cache line");
+static_assert(offsetof(pos_t, state) + sizeof(struct state_s) <= 3 * 64,
+              "pos_t: state must end in 3rd cache line");
+static_assert(offsetof(pos_t, board) == 3 * 64,
+              "pos_t: board must fill 4th cache line");
+#ifndef POS_ATTACKS
+static_assert(POS_COPY_SIZE <= 4 * 64,
+              "pos_t: copy-make part must fit in 4 cache lines");
+#endif
 
 typedef struct state_s state_t;
 
+#ifdef POS_ATTACKS
+void pos_update_attacks(pos_t *pos, const square_t sq);
+#else
+#define pos_update_attacks(pos, sq) do { } while (0)
+#endif
+
 #define pos_pinned(p)                  (p->blockers & p->bb[p->turn][ALL_PIECES])
 
 /**
@@ -90,6 +140,7 @@ static __always_inline void pos_set_sq(pos_t *pos, square_t square, piece_t piec
     pos->board[square] = piece;
     pos->bb[color][type] ^= BIT(square);
     pos->bb[color][ALL_PIECES] ^= BIT(square);
+    pos_update_attacks(pos, square);
     //if (type == KING)
     //    pos->king[color] = square;
 
@@ -116,6 +167,7 @@ static __always_inline void pos_clr_sq(pos_t *pos, square_t square)
     pos->board[square] = EMPTY;
     pos->bb[color][type] ^= BIT(square);
     pos->bb[color][ALL_PIECES] ^= BIT(square);
+    pos_update_attacks(pos, square);
     //if (type == KING)
     //    pos->king[color] = SQUARE_NONE;
 }
@@ -144,6 +196,8 @@ static __always_inline void pos_mv_sq(pos_t *pos, square_t from, square_t to)
     pos->board[to] = pc;
     pos->bb[color][pt] ^= bb_squares;
     pos->bb[color][ALL_PIECES] ^= bb_squares;
+    pos_update_attacks(pos, from);
+    pos_update_attacks(pos, to);
 }
 
 /**
@@ -168,7 +222,7 @@ static __always_inline bitboard_t pos_occ(const pos_t *pos)
 static __always_inline bitboard_t pos_between_occ(const pos_t *pos,
                                                   const square_t sq1, const square_t sq2)
 {
-    return bb_between_excl[sq1][sq2] & pos_occ(pos);
+    return bb_between_excl(sq1, sq2) & pos_occ(pos);
 }
 
 /**
@@ -210,7 +264,9 @@ pos_t *pos_clear(pos_t *pos);
 bool pos_cmp(const pos_t *pos1, const pos_t *pos2);
 
 void pos_set_checkers_pinners_blockers(pos_t *pos);
+void pos_update_checkers_pinners_blockers(pos_t *pos, const move_t move);
 void pos_set_pinners_blockers(pos_t *pos);
+void pos_set_check_info(pos_t *pos);
 bitboard_t pos_checkers(const pos_t *pos, const color_t color);
 bitboard_t pos_king_pinners(const pos_t *pos, const color_t color);
 bitboard_t pos_king_blockers(const pos_t *pos, const color_t color, const bitboard_t );
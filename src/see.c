@@ -0,0 +1,214 @@
+/* see.c - static exchange evaluation.
+ *
+ * Copyright (C) 2024 Bruno Raoult ("br")
+ * Licensed under the GNU General Public License v3.0 or later.
+ * Some rights reserved. See COPYING.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program. If not, see <https://www.gnu.org/licenses/gpl-3.0-standalone.html>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later <https://spdx.org/licenses/GPL-3.0-or-later.html>
+ *
+ */
+
+#include <brlib.h>
+#include <bitops.h>
+#include <bug.h>
+
+#include "chessdefs.h"
+#include "bitboard.h"
+#include "piece.h"
+#include "position.h"
+#include "move.h"
+#include "hq.h"
+#include "attack.h"
+#include "see.h"
+
+/**
+ * see_attackers() - find all attackers on a square, for both colors
+ * @pos: position
+ * @occ: occupation mask used
+ * @sq:  square to test
+ *
+ * Pieces not in @occ (already used in exchange) are removed.
+ *
+ * @Return: a bitboard of attackers.
+ */
+static __always_inline bitboard_t see_attackers(const pos_t *pos, const bitboard_t occ,
+                                                const square_t sq)
+{
+    return (sq_attackers(pos, occ, sq, WHITE) | sq_attackers(pos, occ, sq, BLACK)) & occ;
+}
+
+/**
+ * see_lva() - find least valuable attacker
+ * @pos:       position
+ * @attackers: attackers bitboard (for one color)
+ * @color:     attackers color
+ * @pt:        &piece_type_t, to store attacker piece type
+ *
+ * @Return: attacker bitboard (one bit), 0 if no attacker.
+ */
+static __always_inline bitboard_t see_lva(const pos_t *pos, const bitboard_t attackers,
+                                          const color_t color, piece_type_t *pt)
+{
+    for (*pt = PAWN; *pt <= KING; ++*pt) {
+        bitboard_t bb = attackers & pos->bb[color][*pt];
+        if (bb)
+            return bb & -bb;
+    }
+    return 0;
+}
+
+/**
+ * see_xrays() - add x-ray attackers after removing an attacker
+ * @pos:       position
+ * @occ:       occupation mask (attacker already removed)
+ * @sq:        exchange square
+ * @pt:        removed attacker piece type
+ *
+ * A removed pawn, bishop or queen may uncover a bishop or queen on same
+ * diagonal, and a removed rook or queen may uncover a rook or queen on same
+ * line. Knights and king cannot uncover anything.
+ *
+ * @Return: bitboard of new possible attackers (both colors).
+ */
+static __always_inline bitboard_t see_xrays(const pos_t *pos, const bitboard_t occ,
+                                            const square_t sq, const piece_type_t pt)
+{
+    bitboard_t xrays = 0;
+
+    if (pt == PAWN || pt == BISHOP || pt == QUEEN)
+        xrays |= hq_bishop_moves(occ, sq) &
+            (pos->bb[WHITE][BISHOP] | pos->bb[WHITE][QUEEN] |
+             pos->bb[BLACK][BISHOP] | pos->bb[BLACK][QUEEN]);
+    if (pt == ROOK || pt == QUEEN)
+        xrays |= hq_rook_moves(occ, sq) &
+            (pos->bb[WHITE][ROOK] | pos->bb[WHITE][QUEEN] |
+             pos->bb[BLACK][ROOK] | pos->bb[BLACK][QUEEN]);
+    return xrays & occ;
+}
+
+/**
+ * see() - static exchange evaluation
+ * @pos:  position
+ * @move: move to evaluate
+ *
+ * Evaluate the material balance of the captures sequence on @move
+ * destination square, each side capturing with its least valuable attacker,
+ * and being able to stop the sequence when it becomes unfavorable.
+ * Sliding pieces behind attackers (x-rays) are added as the exchange
+ * progresses.
+ *
+ * Pins are not considered. A king capture is only allowed if the opponent
+ * has no more attackers. Promotions are only considered for @move itself.
+ * Castling always returns zero.
+ *
+ * @Return: material gain for player-to-move (midgame pieces values).
+ */
+eval_t see(const pos_t *pos, const move_t move)
+{
+    square_t from = move_from(move);
+    square_t to   = move_to(move);
+    color_t side  = pos->turn;
+    bitboard_t occ = pos_occ(pos);
+    bitboard_t attackers, bb;
+    piece_type_t pt = PIECE(pos->board[from]);
+    int gain[40], d = 0;
+    int victim;                                   /* piece on @to, after capture */
+
+    if (is_castle(move))
+        return 0;
+
+    gain[0] = piece_midval(PIECE(pos->board[to]));
+    if (is_enpassant(move)) {
+        gain[0] = piece_midval(PAWN);
+        occ ^= BIT(to - sq_up(side));
+    }
+    victim = piece_midval(pt);
+    if (is_promotion(move)) {
+        victim = piece_midval(move_promoted(move));
+        gain[0] += victim - piece_midval(PAWN);
+    }
+
+    occ ^= BIT(from);
+    attackers = see_attackers(pos, occ, to);
+
+    /* gain[d] is the speculative gain if @side captures at depth d and
+     * its piece is recaptured.
+     */
+    while (true) {
+        d++;
+        side = OPPONENT(side);
+        gain[d] = victim - gain[d - 1];
+        bb = see_lva(pos, attackers & pos->bb[side][ALL_PIECES], side, &pt);
+        if (!bb)
+            break;
+        /* king cannot capture a defended piece */
+        if (pt == KING && attackers & pos->bb[OPPONENT(side)][ALL_PIECES])
+            break;
+        occ ^= bb;
+        attackers = (attackers & occ) | see_xrays(pos, occ, to, pt);
+        victim = piece_midval(pt);
+    }
+    while (--d)
+        gain[d - 1] = -max(-gain[d - 1], gain[d]);
+    return gain[0];
+}
+
+/**
+ * see_ge() - check if static exchange evaluation reaches a threshold
+ * @pos:       position
+ * @move:      move to evaluate
+ * @threshold: value to test
+ *
+ * Same as (see(@pos, @move) >= @threshold), but faster, as the exchange is
+ * stopped as soon as the result is known.
+ * Special moves (castling, en-passant and promotions) use see().
+ *
+ * @Return: true if exchange gain is greater or equal than @threshold.
+ */
+bool see_ge(const pos_t *pos, const move_t move, const eval_t threshold)
+{
+    square_t from = move_from(move);
+    square_t to   = move_to(move);
+    color_t side  = pos->turn;
+    bitboard_t occ, attackers, bb;
+    piece_type_t pt;
+    int swap;
+    bool res = true;
+
+    if (move_flags(move))
+        return see(pos, move) >= threshold;
+
+    /* we win the captured piece: are we above threshold if we lose ours ? */
+    swap = piece_midval(PIECE(pos->board[to])) - threshold;
+    if (swap < 0)
+        return false;
+    swap = piece_midval(PIECE(pos->board[from])) - swap;
+    if (swap <= 0)
+        return true;
+
+    occ = pos_occ(pos) ^ BIT(from) ^ BIT(to);
+    attackers = see_attackers(pos, occ, to);
+
+    /* @res is true if @pos->turn wins when @side cannot recapture, @swap is
+     * the value @side has to win to change the result.
+     */
+    while (true) {
+        side = OPPONENT(side);
+        attackers &= occ;
+        bb = see_lva(pos, attackers & pos->bb[side][ALL_PIECES], side, &pt);
+        if (!bb)
+            break;
+        if (pt == KING)                            /* recapture if not defended */
+            return attackers & pos->bb[OPPONENT(side)][ALL_PIECES]? res: !res;
+        res = !res;
+        swap = piece_midval(pt) - swap;
+        if (swap < res)
+            break;
+        occ ^= bb;
+        attackers |= see_xrays(pos, occ, to, pt);
+    }
+    return res;
+}
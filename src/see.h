@@ -0,0 +1,24 @@
+/* see.h - static exchange evaluation.
+ *
+ * Copyright (C) 2024 Bruno Raoult ("br")
+ * Licensed under the GNU General Public License v3.0 or later.
+ * Some rights reserved. See COPYING.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program. If not, see <https://www.gnu.org/licenses/gpl-3.0-standalone.html>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later <https://spdx.org/licenses/GPL-3.0-or-later.html>
+ *
+ */
+
+#ifndef SEE_H
+#define SEE_H
+
+#include "chessdefs.h"
+#include "position.h"
+#include "move.h"
+
+eval_t see(const pos_t *pos, const move_t move);
+bool see_ge(const pos_t *pos, const move_t move, const eval_t threshold);
+
+#endif  /* SEE_H */
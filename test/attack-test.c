@@ -20,6 +20,7 @@
 #include "position.h"
 #include "move-gen.h"
 #include "attack.h"
+#include "hq.h"
 
 #include "common-test.h"
 
@@ -29,6 +30,8 @@ int main(int __unused ac, __unused char**av)
     char *fen;
     pos_t *pos;//, *fishpos = pos_new();
     bitboard_t checkers, pinners, blockers;
+    bitboard_t maps[COLOR_NB][PT_NB], ref, occ, tmp;
+    int errors = 0;
 
     setlinebuf(stdout);                           /* line-buffered stdout */
 
@@ -58,8 +61,40 @@ int main(int __unused ac, __unused char**av)
         bb_print_multi("pinners", 2, pinners, pos->pinners);
         bb_print_multi("blockers", 2, blockers, pos->blockers);
 
+        /* compare whole-board attack maps with per-piece attacks */
+        occ = pos_occ(pos);
+        pos_attack_maps(pos, occ, maps);
+        for (color_t c = WHITE; c <= BLACK; ++c) {
+            for (piece_type_t pt = PAWN; pt <= KING; ++pt) {
+                ref = 0;
+                tmp = pos->bb[c][pt];
+                while (tmp) {
+                    square_t sq = bb_next(&tmp);
+                    switch (pt) {
+                        case PAWN:   ref |= bb_pawn_attacks[c][sq]; break;
+                        case KNIGHT: ref |= bb_knight[sq];          break;
+                        case BISHOP: ref |= hq_bishop_moves(occ, sq); break;
+                        case ROOK:   ref |= hq_rook_moves(occ, sq);   break;
+                        case QUEEN:  ref |= hq_queen_moves(occ, sq);  break;
+                        case KING:   ref |= bb_king[sq];            break;
+                        default: break;
+                    }
+                }
+                if (maps[c][pt] != ref) {
+                    printf("attack map error: color %d piece %d\n", c, pt);
+                    bb_print_multi("maps/ref", 2, maps[c][pt], ref);
+                    errors++;
+                }
+            }
+            if (pos_attacks(pos, occ, c) != maps[c][ALL_PIECES]) {
+                printf("pos_attacks error: color %d\n", c);
+                errors++;
+            }
+        }
+
         pos_del(pos);
         i++;
     }
-    return 0;
+    printf("attack maps: %d errors\n", errors);
+    return errors? 1: 0;
 }
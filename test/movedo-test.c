@@ -13,6 +13,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <unistd.h>
 
 #include "chessdefs.h"
@@ -21,15 +23,60 @@
 #include "move.h"
 #include "move-do.h"
 #include "move-gen.h"
+#include "eval-simple.h"
 
 #include "common-test.h"
 
+static int move_cmp(const void *m1, const void *m2)
+{
+    return *(move_t *)m1 - *(move_t *)m2;
+}
+
+/* sort moves (without scores), to compare generated lists */
+static movelist_t *movelist_sort(movelist_t *list)
+{
+    qsort(list->move, list->nmoves, sizeof(move_t), move_cmp);
+    return list;
+}
+
+static bool movelist_eq(const movelist_t *l1, const movelist_t *l2)
+{
+    return l1->nmoves == l2->nmoves &&
+        !memcmp(l1->move, l2->move, l1->nmoves * sizeof(move_t));
+}
+
+/**
+ * pseudo_legal_mismatch() - check move_is_pseudo_legal() on all move_t values.
+ * @pos: position, with checkers, pinners and blockers set
+ *
+ * Any 16 bits move (e.g. from transposition table) must be accepted by
+ * move_is_pseudo_legal() and pseudo_is_legal() if and only if it is one of
+ * pos_gen_legal() moves.
+ *
+ * @return: first mismatching move value, or -1 if none.
+ */
+static int pseudo_legal_mismatch(pos_t *pos)
+{
+    static bool legal[1 << 16];
+    movelist_t list;
+
+    memset(legal, 0, sizeof(legal));
+    pos_gen_legal(pos, &list);
+    for (int k = 0; k < list.nmoves; ++k)
+        legal[list.move[k]] = true;
+    for (int m = 0; m < (1 << 16); ++m)
+        if ((move_is_pseudo_legal(pos, m) && pseudo_is_legal(pos, m)) != legal[m])
+            return m;
+    return -1;
+}
+
 int main(int __unused ac, __unused char**av)
 {
-    int i = 0, test_line;
+    int i = 0, test_line, bad;
     char *fen, movebuf[8];;
-    pos_t *pos, *savepos;
-    movelist_t movelist;
+    pos_t *pos, *savepos, *copy = pos_new(), *ext = pos_new();
+    movelist_t movelist, child;
+    emovelist_t emovelist;
     move_t *move, *last;
 
     init_all();
@@ -44,16 +91,138 @@ int main(int __unused ac, __unused char**av)
         movelist.nmoves = 0;
         pos_set_checkers_pinners_blockers(pos);
         pos_legal(pos, pos_gen_pseudo(pos, &movelist));
+        pos_set_check_info(pos);
         last = movelist.move + movelist.nmoves;
+
+        if ((bad = pseudo_legal_mismatch(pos)) >= 0) {
+            printf("*** fen %d [%s] move %#x [%s] move_is_pseudo_legal() mismatch\n",
+                   test_line, fen, bad, move_to_str(movebuf, bad, 0));
+            exit(0);
+        }
+
+        /* pos_gen(): when not in check, GEN_CAPTURES and GEN_QUIETS are
+         * disjoint and together equal GEN_ALL. When in check, GEN_EVASIONS
+         * are the legal moves.
+         */
+        if (!pos->checkers) {
+            movelist_t caps, quiets, all;
+
+            pos_gen(pos, &caps, GEN_CAPTURES);
+            pos_gen(pos, &quiets, GEN_QUIETS);
+            memcpy(caps.move + caps.nmoves, quiets.move, quiets.nmoves * sizeof(move_t));
+            caps.nmoves += quiets.nmoves;
+            movelist_sort(&caps);
+            for (int k = 1; k < caps.nmoves; ++k) {
+                if (caps.move[k] == caps.move[k - 1]) {
+                    printf("*** fen %d [%s] move [%s] in GEN_CAPTURES and GEN_QUIETS\n",
+                           test_line, fen, move_to_str(movebuf, caps.move[k], 0));
+                    exit(0);
+                }
+            }
+            if (!movelist_eq(&caps, movelist_sort(pos_gen(pos, &all, GEN_ALL)))) {
+                printf("*** fen %d [%s] GEN_CAPTURES + GEN_QUIETS != GEN_ALL\n",
+                       test_line, fen);
+                exit(0);
+            }
+        } else {
+            movelist_t evasions, legal;
+
+            movelist_sort(pos_gen(pos, &evasions, GEN_EVASIONS));
+            if (!movelist_eq(&evasions, movelist_sort(pos_gen_legal(pos, &legal)))) {
+                printf("*** fen %d [%s] GEN_EVASIONS != legal moves\n",
+                       test_line, fen);
+                exit(0);
+            }
+        }
+
+        /* GEN_QUIET_CHECKS, when not in check: pseudo-legal moves which are
+         * not captures, promotions, castling or e.p., and give check.
+         */
+        if (!pos->checkers) {
+            movelist_t pseudo, checks, qchecks;
+
+            pos_gen_pseudo(pos, &pseudo);
+            checks.nmoves = 0;
+            for (int k = 0; k < pseudo.nmoves; ++k) {
+                move_t m = pseudo.move[k];
+                if (move_flags(m) == M_NORMAL && pos->board[move_to(m)] == EMPTY &&
+                    move_gives_check(pos, m))
+                    checks.move[checks.nmoves++] = m;
+            }
+            movelist_sort(&checks);
+            if (!movelist_eq(&checks, movelist_sort(pos_gen(pos, &qchecks, GEN_QUIET_CHECKS)))) {
+                printf("*** fen %d [%s] GEN_QUIET_CHECKS mismatch\n", test_line, fen);
+                exit(0);
+            }
+        }
         savepos = pos_dup(pos);
+        moves_extend(pos, &movelist, &emovelist);
+        move_score_mvv_lva(pos, &movelist);
+
+        /* move_pick_best() and emove_pick_best(): each move is returned
+         * once, by non-increasing score, then MOVE_NONE.
+         */
+        {
+            movelist_t pick = movelist, all = movelist, epicked;
+            emovelist_t epick = emovelist;
+            int cur = 0, prev = INT_MAX;
+            move_t m;
+            emove_t em;
 
-        state_t state = pos->state;
+            movelist_sort(&all);
+            while ((m = move_pick_best(&pick, &cur)) != MOVE_NONE) {
+                if (m != pick.move[cur - 1] || pick.score[cur - 1] > prev) {
+                    printf("*** fen %d [%s] move %d [%s] move_pick_best() order error\n",
+                           test_line, fen, cur - 1, move_to_str(movebuf, m, 0));
+                    exit(0);
+                }
+                prev = pick.score[cur - 1];
+            }
+            if (cur != movelist.nmoves || !movelist_eq(movelist_sort(&pick), &all)) {
+                printf("*** fen %d [%s] move_pick_best() moves mismatch\n", test_line, fen);
+                exit(0);
+            }
+
+            cur = 0;
+            prev = INT_MAX;
+            epicked.nmoves = 0;
+            while ((em = emove_pick_best(&epick, &cur)) != MOVE_NONE) {
+                if (emove_score(em) > prev) {
+                    printf("*** fen %d [%s] move %d [%s] emove_pick_best() order error\n",
+                           test_line, fen, cur - 1, move_to_str(movebuf, emove_move(em), 0));
+                    exit(0);
+                }
+                prev = emove_score(em);
+                epicked.move[epicked.nmoves++] = emove_move(em);
+            }
+            if (cur != movelist.nmoves || !movelist_eq(movelist_sort(&epicked), &all)) {
+                printf("*** fen %d [%s] emove_pick_best() moves mismatch\n", test_line, fen);
+                exit(0);
+            }
+        }
+
+        state_t state = pos->state, extstate;
         int j = 0;
         for (move = movelist.move; move < last; ++move) {
             //pos_print(pos);
             //printf("i=%d j=%d  turn=%d move=[%s]\n", i, j, pos->turn,
             //       move_to_str(movebuf, *move, 0));
 
+            bool check = move_gives_check(pos, *move);
+            emove_t emove = emovelist.move[j];
+            if (emove_move(emove) != *move || emove_score(emove) != movelist.score[j]) {
+                printf("*** fen %d [%s] move %d [%s] extended move mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
+            move_do_copy(pos, *move, copy);
+            if ((bad = pseudo_legal_mismatch(copy)) >= 0) {
+                printf("*** fen %d [%s] move %d [%s] child move %#x move_is_pseudo_legal() mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0), bad);
+                exit(0);
+            }
+            memcpy(ext, pos, sizeof(pos_t));
+            move_do_ext(ext, emove, &extstate);
             move_do(pos, *move, &state);
             //pos_print(pos);
             //fflush(stdout);
@@ -62,6 +231,47 @@ int main(int __unused ac, __unused char**av)
                        test_line, fen, j, move_to_str(movebuf, *move, 0));
                 exit(0);
             }
+            if (check != !!pos_checkers(pos, pos->turn)) {
+                printf("*** fen %d [%s] move %d [%s] move_gives_check()=%d mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0), check);
+                exit(0);
+            }
+            if (memcmp(pos, copy, POS_COPY_SIZE)) {
+                printf("*** fen %d [%s] move %d [%s] move_do_copy() mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
+            if (memcmp(pos, ext, POS_COPY_SIZE)) {
+                printf("*** fen %d [%s] move %d [%s] move_do_ext() mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
+            if (eval_simple_calc(pos) != pos->psq) {
+                printf("*** fen %d [%s] move %d [%s] material+PST mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
+            if (zobrist_material_calc(pos) != pos->material ||
+                calc_phase(pos) != pos->phase) {
+                printf("*** fen %d [%s] move %d [%s] material key/phase mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
+            state_t incr = pos->state;          /* incremental checkers/pinners */
+            pos_set_checkers_pinners_blockers(pos);
+            if (incr.checkers != pos->checkers ||
+                incr.pinners != pos->pinners || incr.blockers != pos->blockers ||
+                incr.opp_pinners != pos->opp_pinners ||
+                incr.opp_blockers != pos->opp_blockers) {
+                printf("*** fen %d [%s] move %d [%s] checkers/pinners/blockers mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
+            if (pos_has_legal_move(pos) != !!pos_gen_legal(pos, &child)->nmoves) {
+                printf("*** fen %d [%s] move %d [%s] pos_has_legal_move() mismatch\n",
+                       test_line, fen, j, move_to_str(movebuf, *move, 0));
+                exit(0);
+            }
 
             //printf("%d/%d move_do check ok\n", i, j);
             move_undo(pos, *move, &state);
@@ -87,5 +297,7 @@ int main(int __unused ac, __unused char**av)
         pos_del(pos);
         i++;
     }
+    pos_del(copy);
+    pos_del(ext);
     return 0;
 }
@@ -239,9 +239,8 @@ int main(int __unused ac, __unused char**av)
         send_stockfish_fen(outfd, fishpos, &fishmoves, fen);
 
         pos_set_checkers_pinners_blockers(pos);
-        pos_gen_pseudo(pos, &pseudo);
+        pos_gen_legal(pos, &pseudo);
         //moves_print(&pseudo, 0);
-        pos_legal(pos, &pseudo);
 
         //moves_print(&legal, 0);
         //printf("Fu ");
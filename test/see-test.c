@@ -0,0 +1,129 @@
+/* see-test.c - static exchange evaluation tests.
+ *
+ * Copyright (C) 2024 Bruno Raoult ("br")
+ * Licensed under the GNU General Public License v3.0 or later.
+ * Some rights reserved. See COPYING.
+ *
+ * You should have received a copy of the GNU General Public License along with this
+ * program. If not, see <https://www.gnu.org/licenses/gpl-3.0-standalone.html>.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later <https://spdx.org/licenses/GPL-3.0-or-later.html>
+ *
+ */
+
+#include <stdio.h>
+
+#include "chessdefs.h"
+#include "fen.h"
+#include "position.h"
+#include "move.h"
+#include "move-gen.h"
+#include "see.h"
+
+/* expected values use default midgame pieces values:
+ * P=100, N=300, B=300, R=500, Q=900
+ */
+struct seetest {
+    int line;
+    char *fen;
+    char *move;
+    eval_t see;
+} seetest[] = {
+    { __LINE__, "1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1",
+      "e1e5", 100 },
+    { __LINE__, "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1",
+      "d3e5", -200 },
+    { __LINE__, "4R3/2r3p1/5bk1/1p1r3p/p2PR1P1/P1BK1P2/1P6/8 b - - 0 1",
+      "h5g4", 0 },
+    { __LINE__, "4R3/2r3p1/5bk1/1p1r1p1p/p2PR1P1/P1BK1P2/1P6/8 b - - 0 1",
+      "h5g4", 0 },
+    { __LINE__, "4r1k1/5pp1/nbp4p/1p2p2q/1P2P1b1/1BP2N1P/1B2QPPK/3R4 b - - 0 1",
+      "g4f3", 0 },
+    { __LINE__, "2r1r1k1/pp1bppbp/3p1np1/q3P3/2P2P2/1P2B3/P1N1B1PP/2RQ1RK1 b - - 0 1",
+      "d6e5", 100 },
+    { __LINE__, "7r/5qpk/p1Qp1b1p/3r3n/BB3p2/5p2/P1P2P2/4RK1R w - - 0 1",
+      "e1e8", 0 },
+    { __LINE__, "6rr/6pk/p1Qp1b1p/2n5/1B3p2/5p2/P1P2P2/4RK1R w - - 0 1",
+      "e1e8", -500 },
+    { __LINE__, "7r/5qpk/2Qp1b1p/1N1r3n/BB3p2/5p2/P1P2P2/4RK1R w - - 0 1",
+      "e1e8", -500 },
+    { __LINE__, "6RR/4bP2/8/8/5r2/3K4/5p2/4k3 w - - 0 1",
+      "f7f8q", 200 },
+    { __LINE__, "6RR/4bP2/8/8/5r2/3K4/5p2/4k3 w - - 0 1",
+      "f7f8n", 200 },
+    { __LINE__, "7R/5P2/8/8/6r1/3K4/5p2/4k3 w - - 0 1",
+      "f7f8q", 800 },
+    { __LINE__, "7R/5P2/8/8/6r1/3K4/5p2/4k3 w - - 0 1",
+      "f7f8b", 200 },
+    { __LINE__, "7R/4bP2/8/8/1q6/3K4/5p2/4k3 w - - 0 1",
+      "f7f8r", -100 },
+    { __LINE__, "8/4kp2/2npp3/1Nn5/1p2PQP1/7q/1PP1B3/4KR1r b - - 0 1",
+      "h1f1", 0 },
+    { __LINE__, "8/4kp2/2npp3/1Nn5/1p2P1P1/7q/1PP1B3/4KR1r b - - 0 1",
+      "h1f1", 0 },
+    { __LINE__, "2r2r1k/6bp/p7/2q2p1Q/3PpP2/1B6/P5PP/2RR3K b - - 0 1",
+      "c5c1", 100 },
+    { __LINE__, "r2qk1nr/pp2ppbp/2b3p1/2p1p3/8/2N2N2/PPPP1PPP/R1BQR1K1 w kq - 0 1",
+      "f3e5", 100 },
+    { __LINE__, "6r1/4kq2/b2p1p2/p1pPb3/p1P2B1Q/2P4P/2B1R1P1/6K1 w - - 0 1",
+      "f4e5", 0 },
+    { __LINE__, "3q2nk/pb1r1p2/np6/3P2Pp/2p1P3/2R4B/PQ3P1P/3R2K1 w - h6 0 1",
+      "g5h6", 0 },
+    { __LINE__, "3q2nk/pb1r1p2/np6/3P2Pp/2p1P3/2R1B2B/PQ3P1P/3R2K1 w - h6 0 1",
+      "g5h6", 100 },
+    { __LINE__, "2r4r/1P4pk/p2p1b1p/7n/BB3p2/2R2p2/P1P2P2/4RK2 w - - 0 1",
+      "c3c8", 500 },
+    { __LINE__, "2r5/1P4pk/p2p1b1p/5b1n/BB3p2/2R2p2/P1P2P2/4RK2 w - - 0 1",
+      "c3c8", 300 },
+    { __LINE__, "2r4k/2r4p/p7/2b2p1b/4pP2/1BR5/P1R3PP/2Q4K w - - 0 1",
+      "c3c5", 300 },
+    { __LINE__, "8/pp6/2pkp3/4bp2/2R3b1/2P5/PP4B1/1K6 w - - 0 1",
+      "g2c6", -200 },
+    { __LINE__, "4q3/1p1pr1k1/1B2rp2/6p1/p3PP2/P3R1P1/1P2R1K1/4Q3 b - - 0 1",
+      "e6e4", -400 },
+    { __LINE__, "4q3/1p1pr1kb/1B2rp2/6p1/p3PP2/P3R1P1/1P2R1K1/4Q3 b - - 0 1",
+      "h7e4", 100 },
+    { __LINE__, NULL, NULL, 0 }
+};
+
+int main(int __unused ac, __unused char**av)
+{
+    int errors = 0;
+    pos_t *pos;
+    movelist_t movelist;
+    move_t move;
+    eval_t val;
+
+    setlinebuf(stdout);                           /* line-buffered stdout */
+
+    init_all();
+
+    for (struct seetest *t = seetest; t->fen; ++t) {
+        if (!(pos = fen2pos(NULL, t->fen))) {
+            printf("line %3d: wrong fen [%s]\n", t->line, t->fen);
+            errors++;
+            continue;
+        }
+        pos_set_checkers_pinners_blockers(pos);
+        pos_gen_legal(pos, &movelist);
+        move = move_find_in_movelist(move_from_str(t->move), &movelist);
+        if (move == MOVE_NONE) {
+            printf("line %3d: [%s] %s: illegal move\n", t->line, t->fen, t->move);
+            errors++;
+        } else {
+            val = see(pos, move);
+            if (val != t->see ||
+                !see_ge(pos, move, t->see) || see_ge(pos, move, t->see + 1)) {
+                printf("line %3d: [%s] %s: see=%d (expected %d) **ERROR\n",
+                       t->line, t->fen, t->move, val, t->see);
+                errors++;
+            } else {
+                printf("line %3d: [%s] %s: see=%d OK\n",
+                       t->line, t->fen, t->move, val);
+            }
+        }
+        pos_del(pos);
+    }
+    printf("%d errors\n", errors);
+    return errors? 1: 0;
+}